@@ -0,0 +1,55 @@
+// AllocCounter.h
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include "benchmark/benchmark.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts heap allocations by replacing the global operator new. Include from exactly
+// one translation unit per benchmark executable.
+inline std::atomic<uint64_t> allocationCount{0};
+
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+// Reports allocs/frame and frames/s for a loop that handles one frame per iteration
+class FrameCounter
+{
+public:
+    explicit FrameCounter(benchmark::State& state)
+        : state(state), start(allocationCount.load(std::memory_order_relaxed))
+    {
+    }
+
+    ~FrameCounter()
+    {
+        auto allocations = allocationCount.load(std::memory_order_relaxed) - start;
+        state.SetItemsProcessed(state.iterations());
+        state.counters["allocs/frame"] = benchmark::Counter(
+            static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    benchmark::State& state;
+    uint64_t start;
+};
+
+#endif // ALLOC_COUNTER_H
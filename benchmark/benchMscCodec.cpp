@@ -0,0 +1,74 @@
+#include "benchmark/benchmark.h"
+#include "AllocCounter.h"
+#include "../serial/FrameBuilder.h"
+#include "../serial-log/VirtualMsc.h"
+
+// ST-MPC frame codecs: the serial/ FrameBuilder and the serial-log VirtualMsc that answers
+// its frames. Each iteration handles one frame.
+
+namespace
+{
+    constexpr uint8_t MOTOR_ID = 1;
+}
+
+static void BM_BuildGetFrame(benchmark::State& state)
+{
+    FrameBuilder builder;
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto frame = builder.buildGetFrame(MOTOR_ID, ST_MPC::RegisterId::SpeedMeas);
+        benchmark::DoNotOptimize(frame);
+    }
+}
+
+static void BM_BuildSetFrame(benchmark::State& state)
+{
+    FrameBuilder builder;
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto frame = builder.buildSetFrame(MOTOR_ID, ST_MPC::RegisterId::SpeedRef, 1500, ST_MPC::RegisterType::Int32);
+        benchmark::DoNotOptimize(frame);
+    }
+}
+
+static void BM_BuildExecuteFrame(benchmark::State& state)
+{
+    FrameBuilder builder;
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto frame = builder.buildExecuteFrame(MOTOR_ID, ST_MPC::ExecuteId::StartMotor);
+        benchmark::DoNotOptimize(frame);
+    }
+}
+
+static void BM_VirtualMscGet(benchmark::State& state)
+{
+    FrameBuilder builder;
+    VirtualMsc msc;
+    auto request = builder.buildGetFrame(MOTOR_ID, ST_MPC::RegisterId::SpeedRef);
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto response = msc.processFrame(request);
+        benchmark::DoNotOptimize(response);
+    }
+}
+
+static void BM_VirtualMscSet(benchmark::State& state)
+{
+    FrameBuilder builder;
+    VirtualMsc msc;
+    auto request = builder.buildSetFrame(MOTOR_ID, ST_MPC::RegisterId::SpeedRef, 1500, ST_MPC::RegisterType::Int32);
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto response = msc.processFrame(request);
+        benchmark::DoNotOptimize(response);
+    }
+}
+
+BENCHMARK(BM_BuildGetFrame);
+BENCHMARK(BM_BuildSetFrame);
+BENCHMARK(BM_BuildExecuteFrame);
+BENCHMARK(BM_VirtualMscGet);
+BENCHMARK(BM_VirtualMscSet);
+
+BENCHMARK_MAIN();
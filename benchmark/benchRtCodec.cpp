@@ -0,0 +1,184 @@
+#include "benchmark/benchmark.h"
+#include "AllocCounter.h"
+#include "../serial-rt/FrameBuilderRt.h"
+#include "../serial-rt/FrameInterpreterRt.h"
+#include "../serial-rt/VirtualRtMsc.h"
+#include <array>
+
+// Frame codecs of serial-rt. Each iteration encodes or decodes one frame; replies come
+// from VirtualRtMsc so they are byte-identical to what the logger sees on the simulator.
+
+namespace
+{
+    constexpr uint8_t MSC_ID = 1;
+
+    std::vector<uint8_t> replyTo(const std::vector<uint8_t>& request)
+    {
+        VirtualRtMsc msc;
+        return msc.processFrame(request);
+    }
+}
+
+static void BM_BuildReadFrame(benchmark::State& state)
+{
+    FrameBuilderRt builder;
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto frame = builder.buildReadFrame(MSC_ID, RT::RegisterId::CURRENT_SPEED);
+        benchmark::DoNotOptimize(frame);
+    }
+}
+
+static void BM_EncodeReadFrame(benchmark::State& state)
+{
+    FrameBuilderRt builder;
+    FrameBuilderRt::EncodedFrame frame;
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        builder.encodeReadFrame(frame, MSC_ID, RT::RegisterId::CURRENT_SPEED);
+        benchmark::DoNotOptimize(frame);
+    }
+}
+
+static void BM_BuildWriteFrame(benchmark::State& state)
+{
+    FrameBuilderRt builder;
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto frame = builder.buildWriteFrame(MSC_ID, RT::RegisterId::RAMP_FINAL_SPEED, 1500, RT::RegisterType::Int32);
+        benchmark::DoNotOptimize(frame);
+    }
+}
+
+static void BM_BuildFocReadFrame(benchmark::State& state)
+{
+    FrameBuilderRt builder;
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto frame = builder.buildFocReadFrame(MSC_ID, ST_MPC::RegisterId::Ia);
+        benchmark::DoNotOptimize(frame);
+    }
+}
+
+static void BM_EncodeFocReadFrame(benchmark::State& state)
+{
+    FrameBuilderRt builder;
+    FrameBuilderRt::EncodedFrame frame;
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        builder.encodeFocReadFrame(frame, MSC_ID, ST_MPC::RegisterId::Ia);
+        benchmark::DoNotOptimize(frame);
+    }
+}
+
+static void BM_EncodeBatchReadFrame(benchmark::State& state)
+{
+    FrameBuilderRt builder;
+    FrameBuilderRt::EncodedFrame frame;
+    std::array<FrameBuilderRt::BatchItem, RT::MAX_BATCH_REGISTERS> items;
+    for (size_t i = 0; i < items.size(); ++i) {
+        items[i] = {RT::BatchSource::Foc, static_cast<uint8_t>(ST_MPC::RegisterId::Ia)};
+    }
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        builder.encodeBatchReadFrame(frame, MSC_ID, std::span(items.data(), static_cast<size_t>(state.range(0))));
+        benchmark::DoNotOptimize(frame);
+    }
+}
+
+static void BM_InterpretRtRead(benchmark::State& state)
+{
+    FrameBuilderRt builder;
+    FrameInterpreterRt interpreter;
+    auto response = replyTo(builder.buildReadFrame(MSC_ID, RT::RegisterId::CURRENT_SPEED));
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto text = interpreter.interpretResponse(response, RT::RegisterType::Float);
+        benchmark::DoNotOptimize(text);
+    }
+}
+
+static void BM_InterpretFocRead(benchmark::State& state)
+{
+    FrameBuilderRt builder;
+    FrameInterpreterRt interpreter;
+    auto response = replyTo(builder.buildFocReadFrame(MSC_ID, ST_MPC::RegisterId::Ia));
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto text = interpreter.interpretResponse(response, ST_MPC::RegisterType::Int16);
+        benchmark::DoNotOptimize(text);
+    }
+}
+
+// Logger extraction: LoggerRt decodes exactly like this and stores the value per column
+static void BM_DecodeRtRead(benchmark::State& state)
+{
+    FrameBuilderRt builder;
+    auto response = replyTo(builder.buildReadFrame(MSC_ID, RT::RegisterId::CURRENT_SPEED));
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto decoded = FrameInterpreterRt::decode(response, RT::RegisterType::Float);
+        benchmark::DoNotOptimize(decoded);
+    }
+}
+
+static void BM_DecodeFocRead(benchmark::State& state)
+{
+    FrameBuilderRt builder;
+    auto response = replyTo(builder.buildFocReadFrame(MSC_ID, ST_MPC::RegisterId::Ia));
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto decoded = FrameInterpreterRt::decode(response, ST_MPC::RegisterType::Int16);
+        benchmark::DoNotOptimize(decoded);
+    }
+}
+
+static void BM_DecodeBatchRead(benchmark::State& state)
+{
+    FrameBuilderRt builder;
+    std::array<FrameBuilderRt::BatchItem, RT::MAX_BATCH_REGISTERS> items;
+    for (size_t i = 0; i < items.size(); ++i) {
+        items[i] = {RT::BatchSource::Foc, static_cast<uint8_t>(ST_MPC::RegisterId::Ia)};
+    }
+    auto count = static_cast<size_t>(state.range(0));
+    auto response = replyTo(builder.buildBatchReadFrame(MSC_ID, std::span(items.data(), count)));
+    std::array<FrameInterpreterRt::BatchEntry, RT::MAX_BATCH_REGISTERS> entries;
+
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        std::span<FrameInterpreterRt::BatchEntry> view(entries.data(), count);
+        auto batch = FrameInterpreterRt::decodeBatch(response, view);
+        for (const auto& entry : view) {
+            auto decoded = FrameInterpreterRt::decodeBatchEntry(entry, ST_MPC::RegisterType::Int16);
+            benchmark::DoNotOptimize(decoded);
+        }
+        benchmark::DoNotOptimize(batch);
+    }
+}
+
+static void BM_VirtualRtMscProcessFrame(benchmark::State& state)
+{
+    FrameBuilderRt builder;
+    VirtualRtMsc msc;
+    auto request = builder.buildFocReadFrame(MSC_ID, ST_MPC::RegisterId::Ia);
+    FrameCounter counter(state);
+    for (auto _ : state) {
+        auto response = msc.processFrame(request);
+        benchmark::DoNotOptimize(response);
+    }
+}
+
+BENCHMARK(BM_BuildReadFrame);
+BENCHMARK(BM_EncodeReadFrame);
+BENCHMARK(BM_BuildWriteFrame);
+BENCHMARK(BM_BuildFocReadFrame);
+BENCHMARK(BM_EncodeFocReadFrame);
+BENCHMARK(BM_EncodeBatchReadFrame)->Arg(4)->Arg(16);
+BENCHMARK(BM_InterpretRtRead);
+BENCHMARK(BM_InterpretFocRead);
+BENCHMARK(BM_DecodeRtRead);
+BENCHMARK(BM_DecodeFocRead);
+BENCHMARK(BM_DecodeBatchRead)->Arg(4)->Arg(16);
+BENCHMARK(BM_VirtualRtMscProcessFrame);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+// Checksum.h
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Additive frame checksum shared by the RT and ST-MPC protocols: the 16-bit sum of all
+// bytes before the checksum, with its high and low byte added. Usable in constant
+// expressions, so fixed frame prefixes can be summed at compile time. Kept free of
+// C++20 library types because the serial-log tools still build as C++17.
+namespace Checksum
+{
+    constexpr uint8_t fold(uint16_t sum)
+    {
+        return static_cast<uint8_t>((sum & 0x00FF) + (sum >> 8));
+    }
+
+    // Byte sum modulo 2^16; long runs (e.g. CharPtr payloads) take 16 bytes per step
+    constexpr uint16_t sumBytes(const uint8_t* data, size_t size, uint16_t sum = 0)
+    {
+        size_t i = 0;
+#if defined(__SSE2__) && defined(__GNUC__)
+        if (!__builtin_is_constant_evaluated() && size >= 32) {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i acc = zero;
+            for (; i + 16 <= size; i += 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                acc = _mm_add_epi64(acc, _mm_sad_epu8(chunk, zero));
+            }
+            sum = static_cast<uint16_t>(sum + _mm_cvtsi128_si32(acc) + _mm_extract_epi16(acc, 4));
+        }
+#endif
+        for (; i < size; ++i) {
+            sum = static_cast<uint16_t>(sum + data[i]);
+        }
+        return sum;
+    }
+
+    // Running checksum updated as bytes are appended or received
+    class Additive
+    {
+    public:
+        constexpr Additive() = default;
+        constexpr explicit Additive(uint16_t initialSum) : total(initialSum) {}
+
+        constexpr Additive& add(uint8_t byte)
+        {
+            total = static_cast<uint16_t>(total + byte);
+            return *this;
+        }
+
+        constexpr Additive& add(const uint8_t* data, size_t size)
+        {
+            total = sumBytes(data, size, total);
+            return *this;
+        }
+
+        // A byte already included changed value
+        constexpr Additive& replace(uint8_t oldByte, uint8_t newByte)
+        {
+            total = static_cast<uint16_t>(total - oldByte + newByte);
+            return *this;
+        }
+
+        constexpr uint16_t sum() const { return total; }
+        constexpr uint8_t value() const { return fold(total); }
+
+    private:
+        uint16_t total{0};
+    };
+
+    template <size_t N>
+    constexpr uint16_t sumOf(const std::array<uint8_t, N>& bytes)
+    {
+        return sumBytes(bytes.data(), N);
+    }
+
+    constexpr uint8_t of(const uint8_t* data, size_t size)
+    {
+        return fold(sumBytes(data, size));
+    }
+
+    // Checksum of a whole container, e.g. a frame before its checksum byte is appended
+    template <typename Bytes>
+    uint8_t of(const Bytes& bytes)
+    {
+        return of(bytes.data(), bytes.size());
+    }
+
+    // True when the last byte is the checksum of the bytes before it
+    template <typename Bytes>
+    bool verify(const Bytes& frame)
+    {
+        return frame.size() > 0 && of(frame.data(), frame.size() - 1) == frame[frame.size() - 1];
+    }
+}
+
+#endif // CHECKSUM_H
@@ -1,4 +1,5 @@
 #include "FastLogger.h"
+#include "Checksum.h"
 #include <iostream>
 #include <iomanip>
 
@@ -84,12 +85,12 @@ void FastLogger::loggingThread()
 
         for (const auto& regId : m_registers) {
             std::vector<uint8_t> frame = {0x02, 0x01, static_cast<uint8_t>(regId), 0x00}; // Request frame
-            frame[3] = calculateCRC(frame);
+            frame[3] = Checksum::of(frame.data(), 3);
             m_serial.sendFrame(frame);
 
             auto response = m_serial.readFrame();
             if (response.size() >= 4 && static_cast<std::vector<uint8_t>::size_type>(response[1] + 3) == response.size()) {
-                if (response.back() != calculateCRC(response)) {
+                if (!Checksum::verify(response)) {
                     std::cerr << "Invalid CRC in response" << std::endl;
                     m_logFile << ", ";  // Keep output aligned by writing an empty field
                     continue;
@@ -144,11 +145,3 @@ void FastLogger::loggingThread()
     }
 }
 
-uint8_t FastLogger::calculateCRC(const std::vector<uint8_t>& frame)
-{
-    uint16_t sum = 0;
-    for (size_t i = 0; i < frame.size() - 1; ++i) {
-        sum += frame[i];
-    }
-    return static_cast<uint8_t>((sum & 0xFF) + (sum >> 8));
-}
@@ -26,7 +26,6 @@ public:
 private:
     void loggingThread();
     void writeHeader();
-    uint8_t calculateCRC(const std::vector<uint8_t>& frame);
 
     SerialConnection& m_serial;
     const std::unordered_map<ST_MPC::RegisterId, ST_MPC::RegisterType>& m_regTypeMap;
@@ -1,5 +1,6 @@
 // FrameBuilder.cpp
 #include "FrameBuilder.h"
+#include "Checksum.h"
 #include <stdexcept>
 
 std::vector<uint8_t> FrameBuilder::buildSetRegisterFrame(uint8_t motorID, ST_MPC::RegisterId regID, int32_t value, ST_MPC::RegisterType regType) 
@@ -35,7 +36,7 @@ std::vector<uint8_t> FrameBuilder::buildSetRegisterFrame(uint8_t motorID, ST_MPC
     frame.push_back(static_cast<uint8_t>(regID));
     frame.insert(frame.end(), regValBytes.begin(), regValBytes.end());
 
-    uint8_t crc = calculateCRC(frame);
+    uint8_t crc = Checksum::of(frame);
     frame.push_back(crc);
 
     return frame;
@@ -50,7 +51,7 @@ std::vector<uint8_t> FrameBuilder::buildGetRegisterFrame(uint8_t motorID, ST_MPC
     frame.push_back(0x01); // Payload length = 1
     frame.push_back(static_cast<uint8_t>(regID));
 
-    uint8_t crc = calculateCRC(frame);
+    uint8_t crc = Checksum::of(frame);
     frame.push_back(crc);
 
     return frame;
@@ -65,7 +66,7 @@ std::vector<uint8_t> FrameBuilder::buildExecuteFrame(uint8_t motorID, ST_MPC::Ex
     frame.push_back(0x01); // Payload length = 1
     frame.push_back(static_cast<uint8_t>(execID));
 
-    uint8_t crc = calculateCRC(frame);
+    uint8_t crc = Checksum::of(frame);
     frame.push_back(crc);
 
     return frame;
@@ -87,24 +88,8 @@ std::vector<uint8_t> FrameBuilder::buildExecuteRampFrame(uint8_t motorID, int32_
     frame.push_back(static_cast<uint8_t>(duration & 0xFF));
     frame.push_back(static_cast<uint8_t>((duration >> 8) & 0xFF));
 
-    uint8_t crc = calculateCRC(frame);
+    uint8_t crc = Checksum::of(frame);
     frame.push_back(crc);
 
     return frame;
 }
-
-uint8_t FrameBuilder::calculateCRC(const std::vector<uint8_t>& frame) 
-{
-    uint16_t total = 0;
-
-    for (const auto& byte : frame) {
-        total += byte;
-    }
-
-    uint8_t lowByte = total & 0x00FF;
-    uint8_t highByte = (total & 0xFF00) >> 8;
-
-    uint8_t crc = lowByte + highByte;
-
-    return crc;
-}
\ No newline at end of file
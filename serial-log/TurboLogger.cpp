@@ -1,4 +1,5 @@
 #include "TurboLogger.h"
+#include "Checksum.h"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
@@ -107,14 +108,14 @@ void TurboLogger::loggingThread()
             frame[0] = 0x02;
             frame[1] = 0x01;
             frame[2] = static_cast<uint8_t>(regId);
-            frame[3] = calculateCRC(frame);
+            frame[3] = Checksum::of(frame.data(), 3);
             
             m_serial->sendFrame(frame);
             auto response = m_serial->readFrame();
 
             m_buffer[bufferIndex++] = ',';
             if (response.size() >= 4 && response.size() == static_cast<size_t>(response[1] + 3)) {
-                if (response.back() != calculateCRC(response)) {
+                if (!Checksum::verify(response)) {
                     const char* error = "ERROR";
                     size_t errorLen = strlen(error);
                     if (bufferIndex + errorLen < BUFFER_SIZE) {
@@ -201,12 +202,3 @@ void TurboLogger::loggingThread()
     }
     std::cout << "Logging thread exit" << std::endl;
 }
-
-uint8_t TurboLogger::calculateCRC(const std::vector<uint8_t>& frame)
-{
-    uint16_t sum = 0;
-    for (size_t i = 0; i < frame.size() - 1; ++i) {
-        sum += frame[i];
-    }
-    return static_cast<uint8_t>((sum & 0xFF) + (sum >> 8));
-}
\ No newline at end of file
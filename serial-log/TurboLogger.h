@@ -29,7 +29,6 @@ public:
 private:
     void writeHeader();
     void loggingThread();
-    uint8_t calculateCRC(const std::vector<uint8_t>& frame);
 
     SerialConnection* m_serial;
     CommandHandler& m_handler;
@@ -1,4 +1,5 @@
 #include "VirtualMsc.h"
+#include "Checksum.h"
 
 VirtualMsc::VirtualMsc() 
 {    
@@ -21,11 +22,7 @@ std::vector<uint8_t> VirtualMsc::processFrame(const std::vector<uint8_t>& frame)
         return createErrorResponse(0x02); // Payload length mismatch
     }
 
-    uint8_t receivedCRC = frame.back();
-    std::vector<uint8_t> frameWithoutCRC(frame.begin(), frame.end() - 1);
-    uint8_t calculatedCRC = calculateCRC(frameWithoutCRC);
-
-    if (receivedCRC != calculatedCRC) {
+    if (!Checksum::verify(frame)) {
         return createErrorResponse(0x03); // CRC mismatch
     }
 
@@ -52,24 +49,13 @@ std::vector<uint8_t> VirtualMsc::processFrame(const std::vector<uint8_t>& frame)
     return response;
 }
 
-uint8_t VirtualMsc::calculateCRC(const std::vector<uint8_t>& frame) 
-{
-    uint16_t total = 0;
-    for (const auto& byte : frame) {
-        total += byte;
-    }
-    uint8_t lowByte = total & 0x00FF;
-    uint8_t highByte = (total & 0xFF00) >> 8;
-    return lowByte + highByte;
-}
-
 std::vector<uint8_t> VirtualMsc::createSuccessResponse(const std::vector<uint8_t>& payload) 
 {
     std::vector<uint8_t> response;
     response.push_back(SUCCESS_FRAME_ACK);
     response.push_back(payload.size());
     response.insert(response.end(), payload.begin(), payload.end());
-    uint8_t crc = calculateCRC(response);
+    uint8_t crc = Checksum::of(response);
     response.push_back(crc);
     return response;
 }
@@ -77,7 +63,7 @@ std::vector<uint8_t> VirtualMsc::createSuccessResponse(const std::vector<uint8_t
 std::vector<uint8_t> VirtualMsc::createErrorResponse(uint8_t errorCode) 
 {
     std::vector<uint8_t> response = {FAILURE_FRAME_ACK, 0x01, errorCode};
-    uint8_t crc = calculateCRC(response);
+    uint8_t crc = Checksum::of(response);
     response.push_back(crc);
     return response;
 }
@@ -111,7 +97,7 @@ std::vector<uint8_t> VirtualMsc::handleSetCommand(const std::vector<uint8_t>& pa
     }
     
     std::vector<uint8_t> response = {SUCCESS_FRAME_ACK, 0x00};
-    uint8_t crc = calculateCRC(response);
+    uint8_t crc = Checksum::of(response);
     response.push_back(crc);
     return response;
 }
@@ -148,7 +134,7 @@ std::vector<uint8_t> VirtualMsc::handleGetCommand(const std::vector<uint8_t>& pa
         std::get<int16_t>(it->second.value)++;
     }
 
-    uint8_t crc = calculateCRC(response);
+    uint8_t crc = Checksum::of(response);
     response.push_back(crc);
     return response;
 }
@@ -24,7 +24,6 @@ private:
 
     std::map<uint8_t, Register> registers;
 
-    uint8_t calculateCRC(const std::vector<uint8_t>& frame);
     std::vector<uint8_t> createSuccessResponse(const std::vector<uint8_t>& payload);
     std::vector<uint8_t> createErrorResponse(uint8_t errorCode);
     std::vector<uint8_t> handleSetCommand(const std::vector<uint8_t>& payload);
@@ -0,0 +1,53 @@
+// ByteRingBuffer.h
+#ifndef BYTE_RING_BUFFER_H
+#define BYTE_RING_BUFFER_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity byte FIFO used by the receive path. Storage is allocated once;
+// the writer fills contiguous regions directly (e.g. with read()) and the reader
+// inspects and consumes bytes in place.
+class ByteRingBuffer
+{
+public:
+    struct Region
+    {
+        uint8_t* data;
+        size_t size;
+    };
+
+    struct ReadRegion
+    {
+        const uint8_t* data;
+        size_t size;
+    };
+
+    explicit ByteRingBuffer(size_t capacity);
+
+    size_t size() const { return head - tail; }
+    size_t capacity() const { return buffer.size(); }
+    size_t freeSpace() const { return capacity() - size(); }
+    bool empty() const { return head == tail; }
+
+    // Contiguous writable region; call commit() with the number of bytes filled
+    Region writeRegion();
+    void commit(size_t count);
+
+    uint8_t operator[](size_t index) const { return buffer[(tail + index) & mask]; }
+    void copyOut(uint8_t* dest, size_t count) const;
+    // The first count bytes in place; the second region is empty unless they wrap
+    std::array<ReadRegion, 2> readRegions(size_t count) const;
+    void consume(size_t count);
+    void clear() { tail = head; }
+
+private:
+    std::vector<uint8_t> buffer;
+    size_t mask;
+    size_t head{0};     // Total bytes written
+    size_t tail{0};     // Total bytes consumed
+};
+
+#endif // BYTE_RING_BUFFER_H
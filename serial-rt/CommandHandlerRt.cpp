@@ -1,6 +1,8 @@
 #include "CommandHandlerRt.h"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <optional>
 
 CommandHandlerRt::CommandHandlerRt(SerialConnectionRt& conn, uint8_t mscId) 
     : connection(conn), mscId(mscId)
@@ -13,6 +15,7 @@ CommandHandlerRt::CommandHandlerRt(SerialConnectionRt& conn, uint8_t mscId)
         {"foc-read", std::bind(&CommandHandlerRt::handleFocRead, this, std::placeholders::_1)},
         {"foc-write", std::bind(&CommandHandlerRt::handleFocWrite, this, std::placeholders::_1)},
         {"foc-exec", std::bind(&CommandHandlerRt::handleFocExecute, this, std::placeholders::_1)},
+        {"msc", std::bind(&CommandHandlerRt::handleMsc, this, std::placeholders::_1)},
         {"log-start", std::bind(&CommandHandlerRt::handleLogStart, this, std::placeholders::_1)},
         {"log-stop", std::bind(&CommandHandlerRt::handleLogStop, this, std::placeholders::_1)},
         {"log-add-rt", std::bind(&CommandHandlerRt::handleLogAddRt, this, std::placeholders::_1)},
@@ -20,119 +23,14 @@ CommandHandlerRt::CommandHandlerRt(SerialConnectionRt& conn, uint8_t mscId)
         {"log-add-foc", std::bind(&CommandHandlerRt::handleLogAddFoc, this, std::placeholders::_1)},
         {"log-remove-foc", std::bind(&CommandHandlerRt::handleLogRemoveFoc, this, std::placeholders::_1)},
         {"log-status", std::bind(&CommandHandlerRt::handleLogStatus, this, std::placeholders::_1)},
-        {"log-config", std::bind(&CommandHandlerRt::handleLogConfig, this, std::placeholders::_1)}
+        {"log-config", std::bind(&CommandHandlerRt::handleLogConfig, this, std::placeholders::_1)},
+        {"log-rates", std::bind(&CommandHandlerRt::handleLogRates, this, std::placeholders::_1)},
+        {"log-rotate", std::bind(&CommandHandlerRt::handleLogRotate, this, std::placeholders::_1)},
+        {"log-keepalive", std::bind(&CommandHandlerRt::handleLogKeepAlive, this, std::placeholders::_1)},
+        {"log-capture", std::bind(&CommandHandlerRt::handleLogCapture, this, std::placeholders::_1)},
+        {"log-trigger", std::bind(&CommandHandlerRt::handleLogTrigger, this, std::placeholders::_1)},
+        {"link-dump", std::bind(&CommandHandlerRt::handleLinkDump, this, std::placeholders::_1)}
     };
-
-    // Initialize register map
-    registerMap = {
-        {"rt-ramp-final-speed", {RT::RegisterId::RAMP_FINAL_SPEED, RT::RegisterType::Int32}},
-        {"rt-ramp-duration", {RT::RegisterId::RAMP_DURATION, RT::RegisterType::UInt16}},
-        {"rt-speed-ref", {RT::RegisterId::SPEED_SETPOINT, RT::RegisterType::Float}},
-        {"rt-speed-Kp", {RT::RegisterId::SPEED_KP, RT::RegisterType::Float}},
-        {"rt-speed-Ki", {RT::RegisterId::SPEED_KI, RT::RegisterType::Float}},
-        {"rt-speed-Kd", {RT::RegisterId::SPEED_KD, RT::RegisterType::Float}},
-        {"rt-board-info", {RT::RegisterId::BOARD_INFO, RT::RegisterType::CharPtr}},
-        {"rt-speed-meas", {RT::RegisterId::CURRENT_SPEED, RT::RegisterType::Float}},
-        {"rt-speed-loop-period", {RT::RegisterId::SPEED_LOOP_PERIOD_MS, RT::RegisterType::UInt32}},
-        {"rt-git-version", {RT::RegisterId::GIT_VERSION, RT::RegisterType::CharPtr}}
-    };
-
-    // Initialize execute map
-    executeMap = {
-        {"start", RT::ExecuteId::START_MOTOR},
-        {"stop", RT::ExecuteId::STOP_MOTOR},
-        {"ramp", RT::ExecuteId::RAMP_EXECUTE},
-        {"feedback-start", RT::ExecuteId::START_FEEDBACK},
-        {"feedback-stop", RT::ExecuteId::STOP_FEEDBACK}
-    };
-
-    // Initialize FOC register map
-    focRegisterMap = {
-        {"motor-id", {ST_MPC::RegisterId::TargetMotor, ST_MPC::RegisterType::UInt8}},
-        {"flags", {ST_MPC::RegisterId::Flags, ST_MPC::RegisterType::UInt32}},
-        {"status", {ST_MPC::RegisterId::Status, ST_MPC::RegisterType::UInt8}},
-        {"control-mode", {ST_MPC::RegisterId::ControlMode, ST_MPC::RegisterType::UInt8}},
-        {"speed-ref", {ST_MPC::RegisterId::SpeedRef, ST_MPC::RegisterType::Int32}},
-        {"speed-Kp", {ST_MPC::RegisterId::SpeedKp, ST_MPC::RegisterType::Int16}}, // bug in SDK: is Int16
-        {"speed-Ki", {ST_MPC::RegisterId::SpeedKi, ST_MPC::RegisterType::Int16}}, // bug in SDK: is Int16
-        {"speed-Kd", {ST_MPC::RegisterId::SpeedKd, ST_MPC::RegisterType::Int16}}, // bug in SDK: is Int16
-        {"torque-ref", {ST_MPC::RegisterId::TorqueRef, ST_MPC::RegisterType::Int16}},
-        {"torque-Kp", {ST_MPC::RegisterId::TorqueKp, ST_MPC::RegisterType::Int16}}, // bug in SDK: is Int16
-        {"torque-Ki", {ST_MPC::RegisterId::TorqueKi, ST_MPC::RegisterType::Int16}}, // bug in SDK: is Int16
-        {"torque-Kd", {ST_MPC::RegisterId::TorqueKd, ST_MPC::RegisterType::Int16}}, // bug in SDK: is Int16
-        {"flux-ref", {ST_MPC::RegisterId::FluxRef, ST_MPC::RegisterType::Int16}},
-        {"flux-Kp", {ST_MPC::RegisterId::FluxKp, ST_MPC::RegisterType::Int16}},     // bug in SDK: is Int16
-        {"flux-Ki", {ST_MPC::RegisterId::FluxKi, ST_MPC::RegisterType::Int16}},     // bug in SDK: is Int16
-        {"flux-Kd", {ST_MPC::RegisterId::FluxKd, ST_MPC::RegisterType::Int16}},     // bug in SDK: is Int16
-        {"status", {ST_MPC::RegisterId::Status, ST_MPC::RegisterType::UInt8}},
-        {"flags",  {ST_MPC::RegisterId::Flags, ST_MPC::RegisterType::UInt32}},
-        {"control-mode", {ST_MPC::RegisterId::ControlMode, ST_MPC::RegisterType::UInt8}},
-        {"motor-power", {ST_MPC::RegisterId::MotorPower, ST_MPC::RegisterType::UInt16}},
-        {"speed-meas", {ST_MPC::RegisterId::SpeedMeas, ST_MPC::RegisterType::Int32}},
-        {"torque-meas", {ST_MPC::RegisterId::TorqueMeas, ST_MPC::RegisterType::Int16}},
-        {"flux-meas", {ST_MPC::RegisterId::FluxMeas, ST_MPC::RegisterType::Int16}},
-        {"Ia", {ST_MPC::RegisterId::Ia, ST_MPC::RegisterType::Int16}},
-        {"Ib", {ST_MPC::RegisterId::Ib, ST_MPC::RegisterType::Int16}},
-        {"Ialpha", {ST_MPC::RegisterId::Ialpha, ST_MPC::RegisterType::Int16}},
-        {"Ibeta", {ST_MPC::RegisterId::Ibeta, ST_MPC::RegisterType::Int16}},
-        {"Iq", {ST_MPC::RegisterId::Iq, ST_MPC::RegisterType::Int16}},
-        {"Id", {ST_MPC::RegisterId::Id, ST_MPC::RegisterType::Int16}},
-        {"Iq-ref", {ST_MPC::RegisterId::IqRef, ST_MPC::RegisterType::Int16}},
-        {"Id-ref", {ST_MPC::RegisterId::IdRef, ST_MPC::RegisterType::Int16}},
-        {"Vq", {ST_MPC::RegisterId::Vq, ST_MPC::RegisterType::Int16}},
-        {"Vd", {ST_MPC::RegisterId::Vd, ST_MPC::RegisterType::Int16}},
-        {"Valpha", {ST_MPC::RegisterId::Valpha, ST_MPC::RegisterType::Int16}},
-        {"Vbeta", {ST_MPC::RegisterId::Vbeta, ST_MPC::RegisterType::Int16}},
-        {"el-angle-meas", {ST_MPC::RegisterId::ElAngleMeas, ST_MPC::RegisterType::Int16}},
-        {"Iq-ref-speed-mode", {ST_MPC::RegisterId::IqRefSpeedMode, ST_MPC::RegisterType::Int16}},
-        {"ramp-final-speed", {ST_MPC::RegisterId::RampFinalSpeed, ST_MPC::RegisterType::Int32}},
-        {"ramp-duration", {ST_MPC::RegisterId::RampDuration, ST_MPC::RegisterType::UInt16}},
-        {"speed-Kp-div", {ST_MPC::RegisterId::SpeedKpDiv, ST_MPC::RegisterType::UInt16}},
-        {"speed-Ki-div", {ST_MPC::RegisterId::SpeedKiDiv, ST_MPC::RegisterType::UInt16}},
-        {"trans-det-1000", {ST_MPC::RegisterId::TransDetReg1000, ST_MPC::RegisterType::UInt8}},
-        {"trans-det-1200", {ST_MPC::RegisterId::TransDetReg1200, ST_MPC::RegisterType::UInt8}},
-        {"trans-det-1300", {ST_MPC::RegisterId::TransDetReg1300, ST_MPC::RegisterType::UInt8}},
-        {"trans-det-Id", {ST_MPC::RegisterId::TransDetRegId, ST_MPC::RegisterType::UInt8}},
-        {"dead-time-Id", {ST_MPC::RegisterId::DeadTimeRegId, ST_MPC::RegisterType::UInt8}},
-        {"dead-time-A", {ST_MPC::RegisterId::DeadTimeRegA, ST_MPC::RegisterType::UInt8}},
-        {"dead-time-B", {ST_MPC::RegisterId::DeadTimeRegB, ST_MPC::RegisterType::UInt8}},
-        {"gdr-pwr-dis", {ST_MPC::RegisterId::GdrPwrDis, ST_MPC::RegisterType::UInt8}},
-        {"gdr-pwm-en", {ST_MPC::RegisterId::GdrPwmEn, ST_MPC::RegisterType::UInt8}},
-        {"gdr-flt-A", {ST_MPC::RegisterId::GdrFltPhA, ST_MPC::RegisterType::UInt8}},
-        {"gdr-flt-B", {ST_MPC::RegisterId::GdrFltPhB, ST_MPC::RegisterType::UInt8}},
-        {"gdr-flt-C", {ST_MPC::RegisterId::GdrFltPhC, ST_MPC::RegisterType::UInt8}},
-        {"gdr-temp-A", {ST_MPC::RegisterId::GdrTempPhA, ST_MPC::RegisterType::UInt32}},
-        {"gdr-temp-B", {ST_MPC::RegisterId::GdrTempPhB, ST_MPC::RegisterType::UInt32}},
-        {"gdr-temp-C", {ST_MPC::RegisterId::GdrTempPhC, ST_MPC::RegisterType::UInt32}},
-        {"mux-Id", {ST_MPC::RegisterId::MuxRegId, ST_MPC::RegisterType::UInt8}},
-        {"torque-Kp-div-pow2", {ST_MPC::RegisterId::TorqueKpDivPow2, ST_MPC::RegisterType::UInt16}},
-        {"torque-Ki-div-pow2", {ST_MPC::RegisterId::TorqueKiDivPow2, ST_MPC::RegisterType::UInt16}},
-        {"flux-Kp-div-pow2", {ST_MPC::RegisterId::FluxKpDivPow2, ST_MPC::RegisterType::UInt16}},
-        {"flux-Ki-div-pow2", {ST_MPC::RegisterId::FluxKiDivPow2, ST_MPC::RegisterType::UInt16}},
-        {"speed-Kp-div-pow2", {ST_MPC::RegisterId::SpeedKpDivPow2, ST_MPC::RegisterType::UInt16}},
-        {"speed-Ki-div-pow2", {ST_MPC::RegisterId::SpeedKiDivPow2, ST_MPC::RegisterType::UInt16}},
-        {"torque-Kp-div", {ST_MPC::RegisterId::TorqueKpDiv, ST_MPC::RegisterType::UInt16}},
-        {"torque-Ki-div", {ST_MPC::RegisterId::TorqueKiDiv, ST_MPC::RegisterType::UInt16}},
-        {"flux-Kp-div", {ST_MPC::RegisterId::FluxKpDiv, ST_MPC::RegisterType::UInt16}},
-        {"flux-Ki-div", {ST_MPC::RegisterId::FluxKiDiv, ST_MPC::RegisterType::UInt16}},
-        {"align-final-flux", {ST_MPC::RegisterId::AlignFinalFlux, ST_MPC::RegisterType::UInt16}},
-        {"align-ramp-up", {ST_MPC::RegisterId::AlignRampUpDuration, ST_MPC::RegisterType::UInt16}},
-        {"align-ramp-down", {ST_MPC::RegisterId::AlignRampDownDuration, ST_MPC::RegisterType::UInt16}},
-        {"is-aligned", {ST_MPC::RegisterId::IsAligned, ST_MPC::RegisterType::UInt16}},
-        {"git-version", {ST_MPC::RegisterId::GitVersion, ST_MPC::RegisterType::CharPtr}}
-    };
-
-    focExecuteMap = {   
-        {"start", {ST_MPC::ExecuteId::StartMotor}}, 
-        {"stop", {ST_MPC::ExecuteId::StopMotor}}, 
-        {"stop-ramp", {ST_MPC::ExecuteId::StopRamp}},
-        {"reset", {ST_MPC::ExecuteId::Reset}},
-        {"ping", {ST_MPC::ExecuteId::Ping}},
-        {"encoder-align", {ST_MPC::ExecuteId::EncoderAlign}},
-        {"start-stop", {ST_MPC::ExecuteId::StartStop}},
-        {"fault-ack", {ST_MPC::ExecuteId::FaultAck}} 
-    };
-    
 }
 
 CommandHandlerRt::CommandHandlerRt(SerialConnectionRt& conn, uint8_t mscId, LoggerRt& logger)
@@ -176,8 +74,7 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleRead(const std::string&
     try {
         const auto& reg = getRegister(regName);
         auto frame = frameBuilder.buildReadFrame(mscId, reg.id);
-        std::string response = sendAndProcessResponse(frame, reg.type);
-        return {true, response};
+        return toResult(sendAndDecode(frame, reg.type));
     }
     catch (const std::exception& e) {
         return handleError("Read failed", e);
@@ -185,6 +82,16 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleRead(const std::string&
 }
 
 CommandHandlerRt::CommandResult CommandHandlerRt::handleWrite(const std::string& args) 
+{
+    try {
+        return toResult(sendAndDecode(buildWrite(args)));
+    }
+    catch (const std::exception& e) {
+        return handleError("Write failed", e);
+    }
+}
+
+std::vector<uint8_t> CommandHandlerRt::buildWrite(const std::string& args)
 {
     std::istringstream iss(args);
     std::string regName;
@@ -193,29 +100,22 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleWrite(const std::string&
     iss >> regName >> valueStr;
     
     if (regName.empty() || valueStr.empty()) {
-        return {false, "Register name and value required"};
+        throw std::runtime_error("Register name and value required");
     }
 
-    try {
-        const auto& reg = getRegister(regName);
-        int32_t value;
-
-        if (reg.type == RT::RegisterType::Float) {
-            float floatValue;
-            std::istringstream(valueStr) >> floatValue;
-            // Reinterpret float as int32_t for transmission
-            value = *reinterpret_cast<int32_t*>(&floatValue);
-        } else {
-            std::istringstream(valueStr) >> value;
-        }
+    const auto& reg = getRegister(regName);
+    int32_t value;
 
-        auto frame = frameBuilder.buildWriteFrame(mscId, reg.id, value, reg.type);
-        std::string response = sendAndProcessResponse(frame);
-        return {true, response};
-    }
-    catch (const std::exception& e) {
-        return handleError("Write failed", e);
+    if (reg.type == RT::RegisterType::Float) {
+        float floatValue;
+        std::istringstream(valueStr) >> floatValue;
+        // Reinterpret float as int32_t for transmission
+        value = *reinterpret_cast<int32_t*>(&floatValue);
+    } else {
+        std::istringstream(valueStr) >> value;
     }
+
+    return frameBuilder.buildWriteFrame(mscId, reg.id, value, reg.type);
 }
 
 CommandHandlerRt::CommandResult CommandHandlerRt::handleExecute(const std::string& args) 
@@ -238,32 +138,36 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleExecute(const std::strin
             // 1. Set ramp final speed
             auto speedFrame = frameBuilder.buildWriteFrame(mscId, RT::RegisterId::RAMP_FINAL_SPEED, 
                                                          finalSpeed, RT::RegisterType::Float);
-            auto speedResponse = sendAndProcessResponse(speedFrame);
+            auto speedReply = sendAndDecode(speedFrame);
+            if (!speedReply.ok()) {
+                return toResult(speedReply);
+            }
             
             // 2. Set ramp duration
             auto durationFrame = frameBuilder.buildWriteFrame(mscId, RT::RegisterId::RAMP_DURATION, 
                                                             duration, RT::RegisterType::UInt16);
-            auto durationResponse = sendAndProcessResponse(durationFrame);
+            auto durationReply = sendAndDecode(durationFrame);
+            if (!durationReply.ok()) {
+                return toResult(durationReply);
+            }
             
             // 3. Execute ramp command
             auto execFrame = frameBuilder.buildExecuteFrame(mscId, RT::ExecuteId::RAMP_EXECUTE);
-            auto execResponse = sendAndProcessResponse(execFrame);
-
-            if (execResponse.find("Error") != std::string::npos) {
-                return {false, execResponse};
+            auto execReply = sendAndDecode(execFrame);
+            if (!execReply.ok()) {
+                return toResult(execReply);
             }
             return {true, "Ramp command executed successfully"};
         }
         else {
             // Handle other execute commands (start, stop, etc.)
-            auto it = executeMap.find(cmd);
-            if (it == executeMap.end()) {
+            const auto* exec = RegisterTable::findRtExecute(cmd);
+            if (!exec) {
                 return {false, "Unknown execute command: " + cmd};
             }
 
-            auto frame = frameBuilder.buildExecuteFrame(mscId, it->second);
-            std::string response = sendAndProcessResponse(frame);
-            return {true, response};
+            auto frame = frameBuilder.buildExecuteFrame(mscId, exec->id);
+            return toResult(sendAndDecode(frame));
         }
     }
     catch (const std::exception& e) {
@@ -297,43 +201,35 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleFocRead(const std::strin
     std::istringstream iss(args);
     std::string regName;
     iss >> regName;
-    auto it = focRegisterMap.find(regName);
-    if (it == focRegisterMap.end()) {
+    const auto* reg = RegisterTable::findFocRegister(regName);
+    if (!reg) {
         return {false, "Unknown FOC register: " + regName};
     }
 
     try {
-        const auto& reg = it->second;
-        auto frame = frameBuilder.buildFocReadFrame(mscId, reg.id);
-        std::string response = sendAndProcessResponse(frame, reg.type);
-        if (regName == "gdr-temp-A" || regName == "gdr-temp-B" || regName == "gdr-temp-C") {
-            std::size_t start = response.find('=') + 1;
-            std::size_t end = response.find('(');
-            std::string value = response.substr(start, end - start);
-            float temp = std::stof(value) * 5.42f / 100.0f - 244.0f;
-            return {true, response + " (" + std::to_string(temp) + " C)"};
-        } else if (regName == "bus-voltage") {
-            std::size_t start = response.find('=') + 1;
-            std::size_t end = response.find('(');
-            std::string value = response.substr(start, end - start);
-            float voltage = std::stof(value) * 5.0f / 0.001635f / 65536.0f;
-            return {true, response + " (" + std::to_string(voltage) + " V)"};
-        } else if (regName == "control-mode") {
-            std::size_t start = response.find('=') + 1;
-            std::size_t end = response.find('(');
-            std::string value = response.substr(start, end - start);
-            int mode = std::stoi(value);
-            if (mode == 0) {
-                return {true, response + " (Torque)"};
-            } else if (mode == 1) {
-                return {true, response + " (Speed)"};
-            } else {
-                return {true, response + " (Unknown)"};
+        auto frame = frameBuilder.buildFocReadFrame(mscId, reg->id);
+        auto decoded = sendAndDecode(frame, reg->type);
+        auto result = toResult(decoded);
+        auto value = FrameInterpreterRt::toNumber(decoded.value);
+        if (!result.success || !value) {
+            return result;
+        }
+
+        switch (reg->display) {
+            case RegisterTable::Display::GdrTemperature: {
+                float temp = static_cast<float>(*value) * 5.42f / 100.0f - 244.0f;
+                result.message += " (" + std::to_string(temp) + " C)";
+                break;
+            }
+            case RegisterTable::Display::ControlMode: {
+                int mode = static_cast<int>(*value);
+                result.message += mode == 0 ? " (Torque)" : mode == 1 ? " (Speed)" : " (Unknown)";
+                break;
             }
-        } else {
-            return {true, response};
+            case RegisterTable::Display::Raw:
+                break;
         }
-        
+        return result;
     }
     catch (const std::exception& e) {
         return handleError("FOC read failed", e);
@@ -341,28 +237,33 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleFocRead(const std::strin
 }
 
 CommandHandlerRt::CommandResult CommandHandlerRt::handleFocWrite(const std::string& args) 
+{
+    try {
+        ST_MPC::RegisterType type;
+        auto frame = buildFocWrite(args, type);
+        return toResult(sendAndDecode(frame, type));
+    }
+    catch (const std::exception& e) {
+        return handleError("FOC write failed", e);
+    }
+}
+
+std::vector<uint8_t> CommandHandlerRt::buildFocWrite(const std::string& args, ST_MPC::RegisterType& type)
 {
     std::istringstream iss(args);
     std::string regName, valueStr;
-    iss >> regName >> valueStr;  // Skip "foc-write" command
+    iss >> regName >> valueStr;
 
-    auto it = focRegisterMap.find(regName);
-    if (it == focRegisterMap.end()) {
-        return {false, "Unknown FOC register: " + regName};
+    const auto* reg = RegisterTable::findFocRegister(regName);
+    if (!reg) {
+        throw std::runtime_error("Unknown FOC register: " + regName);
     }
 
-    try {
-        const auto& reg = it->second;
-        int32_t value;
-        std::istringstream(valueStr) >> value;
+    int32_t value;
+    std::istringstream(valueStr) >> value;
 
-        auto frame = frameBuilder.buildFocWriteFrame(mscId, reg.id, value, reg.type);
-        std::string response = sendAndProcessResponse(frame, reg.type);
-        return {true, response};
-    }
-    catch (const std::exception& e) {
-        return handleError("FOC write failed", e);
-    }
+    type = reg->type;
+    return frameBuilder.buildFocWriteFrame(mscId, reg->id, value, reg->type);
 }
 
 CommandHandlerRt::CommandResult CommandHandlerRt::handleFocExecute(const std::string& args) 
@@ -370,19 +271,111 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleFocExecute(const std::st
     std::istringstream iss(args);
     std::string execName;
     iss >> execName; 
-    auto it = focExecuteMap.find(execName);
-    if (it == focExecuteMap.end()) {
+    const auto* exec = RegisterTable::findFocExecute(execName);
+    if (!exec) {
         return {false, "Unknown FOC execute command: " + execName};
     }
     try {
-        auto frame = frameBuilder.buildFocExecuteFrame(mscId, it->second);
-        std::string response = sendAndProcessResponse(frame);
-        return {true, response};
+        auto frame = frameBuilder.buildFocExecuteFrame(mscId, exec->id);
+        return toResult(sendAndDecode(frame));
     }
     catch (const std::exception& e) {
         return handleError("FOC execute failed", e);
     }
 }
+
+// Several MSCs share the bus; this selects the one later commands and log-add/remove address
+CommandHandlerRt::CommandResult CommandHandlerRt::handleMsc(const std::string& args)
+{
+    std::istringstream iss(args);
+    std::string idText;
+    iss >> idText;
+    if (idText.empty()) {
+        return {true, "MSC ID: " + std::to_string(mscId)};
+    }
+
+    try {
+        size_t used = 0;
+        unsigned long id = std::stoul(idText, &used);
+        if (used != idText.size() || id > 255) {
+            return {false, "MSC ID must be 0..255"};
+        }
+        mscId = static_cast<uint8_t>(id);
+        return {true, "MSC ID set to " + std::to_string(mscId)};
+    }
+    catch (const std::exception&) {
+        return {false, "MSC ID must be 0..255"};
+    }
+}
+
+uint8_t CommandHandlerRt::getMscId() const
+{
+    return mscId;
+}
+
+bool CommandHandlerRt::isPipelinedCommand(const std::string& command)
+{
+    std::istringstream iss(command);
+    std::string cmd;
+    iss >> cmd;
+    return cmd == "write" || cmd == "foc-write";
+}
+
+std::vector<CommandHandlerRt::CommandResult> CommandHandlerRt::processPipelined(const std::vector<std::string>& commands)
+{
+    std::vector<CommandResult> results(commands.size());
+
+    for (size_t start = 0; start < commands.size(); start += PIPELINE_CHUNK) {
+        size_t end = std::min(commands.size(), start + PIPELINE_CHUNK);
+        std::vector<std::vector<uint8_t>> frames;
+        std::vector<size_t> commandIndex;
+        std::vector<std::optional<ST_MPC::RegisterType>> focTypes;
+        ++scriptConversationId;
+
+        // Encode everything first; a command that does not parse fails on its own
+        for (size_t i = start; i < end; ++i) {
+            std::istringstream iss(commands[i]);
+            std::string cmd;
+            iss >> cmd;
+            std::string args;
+            std::getline(iss, args);
+            try {
+                std::optional<ST_MPC::RegisterType> focType;
+                std::vector<uint8_t> frame;
+                if (cmd == "write") {
+                    frame = buildWrite(args);
+                } else if (cmd == "foc-write") {
+                    ST_MPC::RegisterType type;
+                    frame = buildFocWrite(args, type);
+                    focType = type;
+                } else {
+                    results[i] = {false, "Not a write command: " + cmd};
+                    continue;
+                }
+                FrameBuilderRt::stampTransaction(frame, scriptConversationId, static_cast<uint8_t>(frames.size() + 1));
+                frames.push_back(std::move(frame));
+                commandIndex.push_back(i);
+                focTypes.push_back(focType);
+            }
+            catch (const std::exception& e) {
+                results[i] = handleError(cmd == "write" ? "Write failed" : "FOC write failed", e);
+            }
+        }
+
+        auto replies = connection.transactPipelined(frames, PIPELINE_DEPTH);
+        for (size_t j = 0; j < frames.size(); ++j) {
+            if (replies[j].empty()) {
+                results[commandIndex[j]] = {false, "No reply"};
+                continue;
+            }
+            auto decoded = focTypes[j] ? FrameInterpreterRt::decode(replies[j], *focTypes[j])
+                                       : FrameInterpreterRt::decode(replies[j]);
+            results[commandIndex[j]] = toResult(decoded);
+        }
+    }
+    return results;
+}
+
 // Logging related command handlers
 CommandHandlerRt::CommandResult CommandHandlerRt::handleLogStart(const std::string&) 
 {
@@ -392,7 +385,9 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleLogStart(const std::stri
     
     try {
         logger->start();
-        startPlot();
+        if (!logger->getConfig().telemetryName.empty()) {
+            startPlot();
+        }
         return {true, "Logging started"};
     }
     catch (const std::exception& e) {
@@ -429,10 +424,16 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleLogAddRt(const std::stri
     if (regName.empty()) {
         return {false, "Register name required"};
     }
+    std::optional<LoggerRt::RateClass> rate;
+    bool onChange = false;
+    auto options = parseLogOptions(iss, rate, onChange);
+    if (!options.success) {
+        return options;
+    }
 
     try {
         const auto& reg = getRegister(regName);
-        if (logger->addRtRegister(regName, reg.id, reg.type)) {
+        if (logger->addRtRegister(reg, mscId, rate, onChange)) {
             return {true, "Register added to logging: " + regName};
         }
         return {false, "Register already being logged: " + regName};
@@ -442,6 +443,25 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleLogAddRt(const std::stri
     }
 }
 
+// Options after the register name of log-add-rt/log-add-foc: a rate class and/or 'change'
+CommandHandlerRt::CommandResult CommandHandlerRt::parseLogOptions(std::istream& iss,
+                                                                  std::optional<LoggerRt::RateClass>& rate,
+                                                                  bool& onChange) const
+{
+    std::string option;
+    while (iss >> option) {
+        if (option == "change") {
+            onChange = true;
+            continue;
+        }
+        rate = LoggerRt::parseRateClass(option);
+        if (!rate) {
+            return {false, "Options are a rate ('fast', 'medium' or 'slow') and 'change'"};
+        }
+    }
+    return {true, ""};
+}
+
 CommandHandlerRt::CommandResult CommandHandlerRt::handleLogRemoveRt(const std::string& args) 
 {
     if (!logger) {
@@ -456,7 +476,7 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleLogRemoveRt(const std::s
         return {false, "Register name required"};
     }
 
-    if (logger->removeRtRegister(regName)) {
+    if (logger->removeRtRegister(regName, mscId)) {
         return {true, "Register removed from logging: " + regName};
     }
     return {false, "Register not found in logging: " + regName};
@@ -471,6 +491,27 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleLogStatus(const std::str
     std::stringstream ss;
     ss << "Logging status:\n";
     ss << "Running: " << (logger->isRunning() ? "yes" : "no") << "\n";
+    ss << "Read mode: " << (logger->getConfig().batchRead ? "batch" : "single") << "\n";
+    ss << "Log format: " << (logger->getConfig().format == LoggerRt::LogFormat::Binary ? "binary" : "csv") << "\n";
+    const auto& rotation = logger->getConfig();
+    if (rotation.segmentBytes > 0 || rotation.segmentDuration.count() > 0) {
+        ss << "Rotation: segments of " << rotation.segmentBytes / MEGABYTE << " MB / "
+           << rotation.segmentDuration.count() / 60 << " min, disk budget " << rotation.diskBudget / MEGABYTE << " MB\n";
+    }
+    const auto& capture = rotation.capture;
+    if (capture.enabled) {
+        auto stats = logger->getCaptureStats();
+        ss << "Capture: " << capture.preSamples << " before, " << capture.postSamples << " after, triggers:"
+           << (capture.onFault ? " fault" : "");
+        if (!capture.thresholdColumn.empty()) {
+            ss << " " << capture.thresholdColumn << " " << LoggerRt::edgeName(capture.edge) << " " << capture.level;
+        }
+        ss << " manual\nCaptures: " << stats.captures << (stats.recording ? " (recording)" : "");
+        if (!stats.lastTrigger.empty()) {
+            ss << ", last: " << stats.lastTrigger;
+        }
+        ss << "\n";
+    }
     ss << "Logged registers:";
     
     auto regs = logger->getLoggedRegisters();
@@ -482,6 +523,27 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleLogStatus(const std::str
         }
     }
 
+    const auto& config = logger->getConfig();
+    auto timing = logger->getTimingStats();
+    ss << "\nRates: fast " << config.sampleInterval.count() << " ms, medium every "
+       << config.mediumDivider << " ticks, slow every " << config.slowDivider << " ticks";
+    ss << "\nOn-change keep-alive: " << config.keepAlive.count() << " s";
+    ss << std::fixed << std::setprecision(1);
+    ss << "\nTicks: " << timing.ticks << " (" << timing.overruns << " overruns)";
+    ss << "\nPeriod: mean " << timing.meanPeriodUs << " us, min " << timing.minPeriodUs
+       << " us, max " << timing.maxPeriodUs << " us, jitter " << timing.jitterUs << " us";
+    ss << "\nMax lateness: " << timing.maxLatenessUs << " us";
+
+    auto queue = logger->getQueueStats();
+    ss << "\nWriter queue: " << queue.maxFill << "/" << queue.capacity << " max fill, "
+       << queue.written << " written, " << queue.overflows << " dropped on overflow, "
+       << queue.writeErrors << " dropped on write error";
+
+    auto lane = connection.getInteractiveStats();
+    ss << "\nInteractive commands: " << lane.completed << " (" << lane.failed << " failed), latency mean "
+       << lane.meanLatencyUs << " us, max " << lane.maxLatencyUs << " us";
+    ss << "\n" << LinkStatsRt::formatSummary(connection.getLinkStats().snapshot());
+
     return {true, ss.str()};
 }
 
@@ -498,14 +560,20 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleLogAddFoc(const std::str
     if (regName.empty()) {
         return {false, "Register name required"};
     }
+    std::optional<LoggerRt::RateClass> rate;
+    bool onChange = false;
+    auto options = parseLogOptions(iss, rate, onChange);
+    if (!options.success) {
+        return options;
+    }
 
     try {
-        const auto& reg = focRegisterMap.find(regName);
-        if (reg == focRegisterMap.end()) {
+        const auto* reg = RegisterTable::findFocRegister(regName);
+        if (!reg) {
             return {false, "Unknown FOC register: " + regName};
         }
 
-        if (logger->addFocRegister(regName, reg->second.id, reg->second.type)) {
+        if (logger->addFocRegister(*reg, mscId, rate, onChange)) {
             return {true, "FOC register added to logging: " + regName};
         }
         return {false, "FOC register already being logged: " + regName};
@@ -529,7 +597,7 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleLogRemoveFoc(const std::
         return {false, "Register name required"};
     }
 
-    if (logger->removeFocRegister(regName)) {
+    if (logger->removeFocRegister(regName, mscId)) {
         return {true, "FOC register removed from logging: " + regName};
     }
     return {false, "FOC register not found in logging: " + regName};
@@ -543,18 +611,26 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleLogConfig(const std::str
 
     std::istringstream iss(args);
     std::string filename;
-    int interval;
+    int interval = 0;
+    std::string mode;
     
-    iss >> filename >> interval;
+    iss >> filename >> interval >> mode;
     
     if (filename.empty() || interval <= 0) {
         return {false, "Filename and positive interval required"};
     }
+    if (!mode.empty() && mode != "single" && mode != "batch") {
+        return {false, "Read mode must be 'single' or 'batch'"};
+    }
 
     try {
         auto config = logger->getConfig();
         config.filename = filename;
         config.sampleInterval = std::chrono::milliseconds(interval);
+        config.format = LoggerRt::formatForFile(filename);
+        if (!mode.empty()) {
+            config.batchRead = (mode == "batch");
+        }
         logger->setConfig(config);
         return {true, "Logger configuration updated"};
     }
@@ -563,60 +639,239 @@ CommandHandlerRt::CommandResult CommandHandlerRt::handleLogConfig(const std::str
     }
 }
 
+CommandHandlerRt::CommandResult CommandHandlerRt::handleLogRates(const std::string& args) 
+{
+    if (!logger) {
+        return {false, "Logger not initialized"};
+    }
+
+    std::istringstream iss(args);
+    int mediumDivider = 0;
+    int slowDivider = 0;
+    iss >> mediumDivider >> slowDivider;
+
+    if (mediumDivider <= 0 || slowDivider <= 0) {
+        return {false, "Positive medium and slow dividers required"};
+    }
+
+    try {
+        auto config = logger->getConfig();
+        config.mediumDivider = static_cast<uint32_t>(mediumDivider);
+        config.slowDivider = static_cast<uint32_t>(slowDivider);
+        logger->setConfig(config);
+        return {true, "Logger rates updated"};
+    }
+    catch (const std::exception& e) {
+        return handleError("Failed to update logger rates", e);
+    }
+}
+
+CommandHandlerRt::CommandResult CommandHandlerRt::handleLogRotate(const std::string& args)
+{
+    if (!logger) {
+        return {false, "Logger not initialized"};
+    }
+
+    std::istringstream iss(args);
+    std::string first;
+    iss >> first;
+    uint64_t segmentMb = 0;
+    uint64_t minutes = 0;
+    uint64_t budgetMb = 0;
+    if (first != "off") {
+        try {
+            segmentMb = std::stoull(first);
+        }
+        catch (const std::exception&) {
+            return {false, "Segment size in MB or 'off' required"};
+        }
+        iss >> minutes >> budgetMb;
+        if (segmentMb == 0 && minutes == 0) {
+            return {false, "Segment size or duration must be positive"};
+        }
+        if (budgetMb > 0 && budgetMb < segmentMb) {
+            return {false, "Disk budget must hold at least one segment"};
+        }
+    }
+
+    try {
+        auto config = logger->getConfig();
+        config.segmentBytes = segmentMb * MEGABYTE;
+        config.segmentDuration = std::chrono::minutes(minutes);
+        config.diskBudget = budgetMb * MEGABYTE;
+        logger->setConfig(config);
+        return {true, first == "off" ? "Log rotation disabled" : "Log rotation updated"};
+    }
+    catch (const std::exception& e) {
+        return handleError("Failed to update log rotation", e);
+    }
+}
+
+CommandHandlerRt::CommandResult CommandHandlerRt::handleLogKeepAlive(const std::string& args)
+{
+    if (!logger) {
+        return {false, "Logger not initialized"};
+    }
+
+    std::istringstream iss(args);
+    int seconds = -1;
+    iss >> seconds;
+    if (seconds < 0) {
+        return {false, "Keep-alive in seconds required (0 = only on change)"};
+    }
+
+    try {
+        auto config = logger->getConfig();
+        config.keepAlive = std::chrono::seconds(seconds);
+        logger->setConfig(config);
+        return {true, "On-change keep-alive set to " + std::to_string(seconds) + " s"};
+    }
+    catch (const std::exception& e) {
+        return handleError("Failed to update keep-alive", e);
+    }
+}
+
+CommandHandlerRt::CommandResult CommandHandlerRt::handleLogCapture(const std::string& args)
+{
+    if (!logger) {
+        return {false, "Logger not initialized"};
+    }
+
+    std::istringstream iss(args);
+    std::string first;
+    iss >> first;
+    LoggerRt::CaptureConfig capture;
+    if (first != "off") {
+        try {
+            capture.preSamples = std::stoull(first);
+            std::string post;
+            iss >> post;
+            capture.postSamples = std::stoull(post);
+        }
+        catch (const std::exception&) {
+            return {false, "Sample counts before and after the trigger or 'off' required"};
+        }
+        if (capture.preSamples > LoggerRt::MAX_CAPTURE_SAMPLES || capture.postSamples > LoggerRt::MAX_CAPTURE_SAMPLES) {
+            return {false, "At most " + std::to_string(LoggerRt::MAX_CAPTURE_SAMPLES) + " samples before and after"};
+        }
+
+        std::string word;
+        while (iss >> word) {
+            if (word == "fault") {
+                capture.onFault = true;
+                continue;
+            }
+            std::string edgeName;
+            iss >> edgeName >> capture.level;
+            auto edge = LoggerRt::parseEdge(edgeName);
+            if (!edge || iss.fail()) {
+                return {false, "Threshold trigger: <column> rising|falling|either <level>"};
+            }
+            capture.thresholdColumn = word;
+            capture.edge = *edge;
+        }
+        capture.enabled = true;
+    }
+
+    try {
+        auto config = logger->getConfig();
+        config.capture = capture;
+        logger->setConfig(config);
+        return {true, capture.enabled ? "Capture armed on next log-start" : "Capture disabled"};
+    }
+    catch (const std::exception& e) {
+        return handleError("Failed to update capture", e);
+    }
+}
+
+CommandHandlerRt::CommandResult CommandHandlerRt::handleLogTrigger(const std::string&)
+{
+    if (!logger) {
+        return {false, "Logger not initialized"};
+    }
+    if (!logger->isRunning() || !logger->getConfig().capture.enabled) {
+        return {false, "No capture armed"};
+    }
+    logger->trigger();
+    return {true, "Capture triggered"};
+}
+
+CommandHandlerRt::CommandResult CommandHandlerRt::handleLinkDump(const std::string& args)
+{
+    std::istringstream iss(args);
+    std::string filename;
+    int intervalMs = 1000;
+    iss >> filename >> intervalMs;
+
+    if (filename.empty()) {
+        return {false, "File name or 'off' required"};
+    }
+    if (filename == "off") {
+        linkDump.stop();
+        return {true, "Link statistics dump stopped"};
+    }
+    if (intervalMs <= 0) {
+        return {false, "Positive interval in ms required"};
+    }
+
+    try {
+        linkDump.start(connection.getLinkStats(), filename, std::chrono::milliseconds(intervalMs));
+        return {true, "Appending link statistics to " + filename + " every " + std::to_string(intervalMs) + " ms"};
+    }
+    catch (const std::exception& e) {
+        return handleError("Failed to start link statistics dump", e);
+    }
+}
+
 CommandHandlerRt::CommandResult CommandHandlerRt::handleError(const std::string& message, 
                                                             const std::exception& e) const 
 {
     return {false, message + ": " + e.what()};
 }
 
-const CommandHandlerRt::Register& CommandHandlerRt::getRegister(const std::string& regName) 
+const RegisterTable::RtRegister& CommandHandlerRt::getRegister(const std::string& regName) 
 {
-    auto it = registerMap.find(regName);
-    if (it == registerMap.end()) {
+    const auto* reg = RegisterTable::findRtRegister(regName);
+    if (!reg) {
         throw std::runtime_error("Unknown register: " + regName);
     }
-    return it->second;
+    return *reg;
+}
+
+FrameInterpreterRt::Decoded CommandHandlerRt::sendAndDecode(const std::vector<uint8_t>& frame) 
+{
+    lastResponse = connection.transactAsync(frame).get();
+    return FrameInterpreterRt::decode(lastResponse);
 }
 
-std::string CommandHandlerRt::sendAndProcessResponse(const std::vector<uint8_t>& frame) 
+FrameInterpreterRt::Decoded CommandHandlerRt::sendAndDecode(const std::vector<uint8_t>& frame, 
+                                                           RT::RegisterType type) 
 {
-    connection.sendFrame(frame);
-    auto response = connection.readFrame();
-    return frameInterpreter.interpretResponse(response);
+    lastResponse = connection.transactAsync(frame).get();
+    return FrameInterpreterRt::decode(lastResponse, type);
 }
 
-std::string CommandHandlerRt::sendAndProcessResponse(const std::vector<uint8_t>& frame, 
-                                                   RT::RegisterType type) 
+FrameInterpreterRt::Decoded CommandHandlerRt::sendAndDecode(const std::vector<uint8_t>& frame, 
+                                                           ST_MPC::RegisterType type) 
 {
-    connection.sendFrame(frame);
-    auto response = connection.readFrame();
-    return frameInterpreter.interpretResponse(response, type);
+    lastResponse = connection.transactAsync(frame).get();
+    return FrameInterpreterRt::decode(lastResponse, type);
 }
 
-std::string CommandHandlerRt::sendAndProcessResponse(const std::vector<uint8_t>& frame, 
-                                                   ST_MPC::RegisterType type) 
+CommandHandlerRt::CommandResult CommandHandlerRt::toResult(const FrameInterpreterRt::Decoded& decoded) const
 {
-    connection.sendFrame(frame);
-    auto response = connection.readFrame();
-    return frameInterpreter.interpretResponse(response, type);
+    if (!decoded.ok()) {
+        return {false, frameInterpreter.describeError(decoded)};
+    }
+    return {true, frameInterpreter.format(decoded)};
 }
 
 const std::string CommandHandlerRt::printAllRegisters() const 
 {
     std::stringstream ss;
     ss << "Available registers:\n";
-    for (const auto& reg : registerMap) {
-        ss << "  " << std::setw(20) << std::left << reg.first;
-        switch (reg.second.type) {
-            case RT::RegisterType::UInt8: ss << "UINT8"; break;
-            case RT::RegisterType::Int16: ss << "INT16"; break;
-            case RT::RegisterType::UInt16: ss << "UINT16"; break;
-            case RT::RegisterType::Int32: ss << "INT32"; break;
-            case RT::RegisterType::UInt32: ss << "UINT32"; break;
-            case RT::RegisterType::Float: ss << "FLOAT"; break;
-            case RT::RegisterType::CharPtr: ss << "STRING"; break;
-        }
-        ss << "\n";
+    for (const auto& reg : RegisterTable::RT_REGISTERS) {
+        ss << "  " << std::setw(20) << std::left << reg.name << RegisterTable::typeName(reg.type) << "\n";
     }
     return ss.str();
 }
@@ -625,8 +880,8 @@ const std::string CommandHandlerRt::printAllExecutes() const
 {
     std::stringstream ss;
     ss << "Available execute commands:\n";
-    for (const auto& exec : executeMap) {
-        ss << "  " << exec.first << "\n";
+    for (const auto& exec : RegisterTable::RT_EXECUTES) {
+        ss << "  " << exec.name << "\n";
     }
     return ss.str();
 }
@@ -635,17 +890,9 @@ const std::string CommandHandlerRt::printAllFocRegisters() const
 {
     std::stringstream ss;
     ss << "Available registers:\n";
-    for (const auto& reg : focRegisterMap) {
-        ss << "  " << std::setw(20) << std::left << reg.first;
-        switch (reg.second.type) {
-            case ST_MPC::RegisterType::UInt8: ss << "UINT8"; break;
-            case ST_MPC::RegisterType::Int16: ss << "INT16"; break;
-            case ST_MPC::RegisterType::UInt16: ss << "UINT16"; break;
-            case ST_MPC::RegisterType::Int32: ss << "INT32"; break;
-            case ST_MPC::RegisterType::UInt32: ss << "UINT32"; break;
-            case ST_MPC::RegisterType::CharPtr: ss << "STRING"; break;
-        }
-        ss << "\n";
+    for (const auto& reg : RegisterTable::FOC_REGISTERS) {
+        ss << "  " << std::setw(20) << std::left << reg.name
+           << RegisterTable::typeName(RegisterTable::toRtType(reg.type)) << "\n";
     }
     return ss.str();
 }
@@ -654,8 +901,8 @@ const std::string CommandHandlerRt::printAllFocExecutes() const
 {
     std::stringstream ss;
     ss << "Available FOC execute commands:\n";
-    for (const auto& exec : focExecuteMap) {
-        ss << "  " << exec.first << "\n";
+    for (const auto& exec : RegisterTable::FOC_EXECUTES) {
+        ss << "  " << exec.name << "\n";
     }
     return ss.str();
 }
@@ -664,9 +911,11 @@ void CommandHandlerRt::startPlot()
 {
     pid_t pid = fork();
     if (pid == 0) {
+        // The plotter follows the logger's shared memory feed, not the log file
         LoggerRt::LogConfig config = logger->getConfig();
-        execlp("python3", "python3", "plot.py", config.filename.c_str(), nullptr);
+        execlp("python3", "python3", "plot.py", config.telemetryName.c_str(), nullptr);
         std::cerr << "Failed to start plotter process" << std::endl;
+        _exit(1);
     } else if (pid > 0) {
         std::cout << "Plotter process started with PID " << pid << std::endl;
         plotterPid = pid;
@@ -6,6 +6,8 @@
 #include "FrameInterpreterRt.h"
 #include "RtDefinitions.h"
 #include "StMpcDefinitions.h"
+#include "RegisterTableRt.h"
+#include "LinkStatsRt.h"
 #include <string>
 #include <unordered_map>
 #include <functional>
@@ -23,23 +25,22 @@ public:
     CommandHandlerRt(SerialConnectionRt& conn, uint8_t mscId);
     CommandHandlerRt(SerialConnectionRt& conn, uint8_t mscId, LoggerRt& logger);
     CommandResult processCommand(const std::string& command);
+
+    // Script execution: write and foc-write commands do not depend on each other's replies,
+    // so a run of them is sent back-to-back and the replies are matched afterwards.
+    // Returns one result per command, in order.
+    static bool isPipelinedCommand(const std::string& command);
+    std::vector<CommandResult> processPipelined(const std::vector<std::string>& commands);
+    // Pipelined writes in flight and per processPipelined() chunk; seqIds are 1..255
+    static constexpr size_t PIPELINE_DEPTH = 8;
+    static constexpr size_t PIPELINE_CHUNK = 64;
+    uint8_t getMscId() const;
     const std::string printAllRegisters() const;
     const std::string printAllExecutes() const;
     const std::string printAllFocRegisters() const;
     const std::string printAllFocExecutes() const;
 
 private:
-    struct Register 
-    {
-        RT::RegisterId id;
-        RT::RegisterType type;
-    };
-    struct FocRegister
-    {
-        ST_MPC::RegisterId id;
-        ST_MPC::RegisterType type;
-    };
-
     // Command handlers
     CommandResult handleRead(const std::string& args);
     CommandResult handleWrite(const std::string& args);
@@ -48,6 +49,7 @@ private:
     CommandResult handleFocRead(const std::string& args);
     CommandResult handleFocWrite(const std::string& args);
     CommandResult handleFocExecute(const std::string& args);
+    CommandResult handleMsc(const std::string& args);
 
     CommandResult handleLogStart(const std::string& args);
     CommandResult handleLogStop(const std::string& args);
@@ -59,27 +61,41 @@ private:
 
     CommandResult handleLogStatus(const std::string& args);
     CommandResult handleLogConfig(const std::string& args);
+    CommandResult handleLogRates(const std::string& args);
+    CommandResult handleLogRotate(const std::string& args);
+    CommandResult handleLogKeepAlive(const std::string& args);
+    CommandResult handleLogCapture(const std::string& args);
+    CommandResult handleLogTrigger(const std::string& args);
+    CommandResult handleLinkDump(const std::string& args);
     CommandResult handleError(const std::string& message, const std::exception& e) const;
+    CommandResult parseLogOptions(std::istream& iss, std::optional<LoggerRt::RateClass>& rate,
+                                  bool& onChange) const;
+
+    static constexpr uint64_t MEGABYTE = 1024 * 1024;
 
     // Helper methods
-    const Register& getRegister(const std::string& regName);
-    std::string sendAndProcessResponse(const std::vector<uint8_t>& frame);
-    std::string sendAndProcessResponse(const std::vector<uint8_t>& frame, RT::RegisterType type);
-    std::string sendAndProcessResponse(const std::vector<uint8_t>& frame, ST_MPC::RegisterType type);
+    const RegisterTable::RtRegister& getRegister(const std::string& regName);
+    std::vector<uint8_t> buildWrite(const std::string& args);
+    std::vector<uint8_t> buildFocWrite(const std::string& args, ST_MPC::RegisterType& type);
+    // Decoded values may view into lastResponse; they stay valid until the next send
+    FrameInterpreterRt::Decoded sendAndDecode(const std::vector<uint8_t>& frame);
+    FrameInterpreterRt::Decoded sendAndDecode(const std::vector<uint8_t>& frame, RT::RegisterType type);
+    FrameInterpreterRt::Decoded sendAndDecode(const std::vector<uint8_t>& frame, ST_MPC::RegisterType type);
+    CommandResult toResult(const FrameInterpreterRt::Decoded& decoded) const;
 
     // Member variables
     SerialConnectionRt& connection;
     FrameBuilderRt frameBuilder;
     FrameInterpreterRt frameInterpreter;
+    std::vector<uint8_t> lastResponse;
     LoggerRt* logger = nullptr;
-    uint8_t mscId;
+    uint8_t mscId;      // Target of all following commands, see handleMsc
+    uint8_t scriptConversationId{0};
 
     // Maps
     std::unordered_map<std::string, std::function<CommandResult(const std::string&)>> commandMap;
-    std::unordered_map<std::string, Register> registerMap;
-    std::unordered_map<std::string, RT::ExecuteId> executeMap;
-    std::unordered_map<std::string, FocRegister> focRegisterMap;
-    std::unordered_map<std::string, ST_MPC::ExecuteId> focExecuteMap;
+
+    LinkStatsDumpRt linkDump;
 
     pid_t plotterPid{0};  // PID of plotter process
     void startPlot();
@@ -2,27 +2,112 @@
 #include <sstream>
 #include <cstring>
 
-std::vector<uint8_t> FrameBuilderRt::FrameData::complete() 
+namespace {
+
+using Header = std::array<uint8_t, RT::HEADER_SIZE>;
+using HeaderTemplate = FrameBuilderRt::HeaderTemplate;
+
+// Header with sizes and mscId left zero; those are filled in per frame. The byte sum of
+// the constant part is folded in at compile time.
+constexpr HeaderTemplate makeHeader(uint8_t msgRequestId, uint8_t conversationId, uint8_t senderId,
+                                    uint8_t seqId, RT::CommandId commandId)
+{
+    Header bytes = {
+        RT::START_BYTE, 0x00, 0x00, 0x00,                   // startByte, totalSize, payloadSize, mscId
+        msgRequestId, 0x00, conversationId, senderId,       // msgRequestId, msgResponseId, conversationId, senderId
+        0x01, seqId, static_cast<uint8_t>(commandId),       // numBlocks, seqId, commandType
+        static_cast<uint8_t>(RT::ErrorId::NO_ERROR),        // errorCode
+        0x00, 0x00, 0x00, RT::END_BYTE                      // futureUse0-2, endByte
+    };
+    return {bytes, Checksum::sumOf(bytes)};
+}
+
+constexpr HeaderTemplate READ_HEADER = makeHeader(0x01, 0x01, 0x01, 0x01, RT::CommandId::RT_READ);
+constexpr HeaderTemplate WRITE_HEADER = makeHeader(0x0a, 0x63, 0x01, 0x01, RT::CommandId::RT_WRITE);
+constexpr HeaderTemplate EXECUTE_HEADER = makeHeader(0x00, 0x00, 0x00, 0x00, RT::CommandId::RT_EXECUTE);
+constexpr HeaderTemplate FOC_READ_HEADER = makeHeader(0x0c, 0x63, 0x01, 0x01, RT::CommandId::FOC_COMMAND);
+constexpr HeaderTemplate FOC_WRITE_HEADER = makeHeader(0x0d, 0x63, 0x01, 0x01, RT::CommandId::FOC_COMMAND);
+constexpr HeaderTemplate FOC_EXECUTE_HEADER = makeHeader(0x0e, 0x63, 0x01, 0x01, RT::CommandId::FOC_COMMAND);
+constexpr HeaderTemplate BATCH_READ_HEADER = makeHeader(0x0f, 0x01, 0x01, 0x01, RT::CommandId::RT_BATCH_READ);
+
+} // namespace
+
+void FrameBuilderRt::FrameData::setHeader(const HeaderTemplate& header, uint8_t mscId,
+                                          uint8_t totalSize, uint8_t payloadSize)
 {
-    frame.push_back(calculateCRC());
-    return frame;
+    std::memcpy(frame.bytes.data(), header.bytes.data(), header.bytes.size());
+    frame.size = static_cast<uint8_t>(header.bytes.size());
+    frame.bytes[static_cast<size_t>(RT::HeaderIndex::TotalSize)] = totalSize;
+    frame.bytes[static_cast<size_t>(RT::HeaderIndex::PayloadSize)] = payloadSize;
+    frame.bytes[static_cast<size_t>(RT::HeaderIndex::MscId)] = mscId;
+    frame.checksum = Checksum::Additive(header.sum).add(totalSize).add(payloadSize).add(mscId);
 }
 
-uint8_t FrameBuilderRt::FrameData::calculateCRC() const 
+void FrameBuilderRt::FrameData::setHeaderField(RT::HeaderIndex index, uint8_t value)
 {
-    uint16_t sum = 0;
-    for(size_t i = 0; i < frame.size(); i++) {
-        sum += frame[i];
+    uint8_t& field = frame.bytes[static_cast<size_t>(index)];
+    frame.checksum.replace(field, value);
+    field = value;
+}
+
+void FrameBuilderRt::FrameData::addPayloadByte(uint8_t byte)
+{
+    if (frame.size >= MAX_FRAME_SIZE - 1) {     // Keep room for the CRC
+        throw FrameError("Frame exceeds maximum size");
     }
-    return static_cast<uint8_t>((sum >> 8) + (sum & 0x00FF));
+    frame.bytes[frame.size++] = byte;
+    frame.checksum.add(byte);
 }
 
-void FrameBuilderRt::FrameData::addPayloadBytes(const std::vector<uint8_t>& bytes) 
+void FrameBuilderRt::FrameData::addPayloadBytes(const uint8_t* bytes, size_t count)
 {
-    frame.insert(frame.end(), bytes.begin(), bytes.end());
+    if (frame.size + count > MAX_FRAME_SIZE - 1) {
+        throw FrameError("Frame exceeds maximum size");
+    }
+    std::memcpy(frame.bytes.data() + frame.size, bytes, count);
+    frame.size = static_cast<uint8_t>(frame.size + count);
+    frame.checksum.add(bytes, count);
 }
 
-void FrameBuilderRt::validateValue(int32_t value, RT::RegisterType type) 
+void FrameBuilderRt::FrameData::complete()
+{
+    frame.bytes[frame.size++] = frame.checksum.value();
+}
+
+std::vector<uint8_t> FrameBuilderRt::toVector(const EncodedFrame& frame)
+{
+    auto view = frame.view();
+    return std::vector<uint8_t>(view.begin(), view.end());
+}
+
+void FrameBuilderRt::stampTransaction(std::vector<uint8_t>& frame, uint8_t conversationId, uint8_t seqId)
+{
+    if (frame.size() <= RT::HEADER_SIZE) {
+        throw FrameError("Frame too short to stamp transaction ids");
+    }
+    frame[static_cast<size_t>(RT::HeaderIndex::ConversationId)] = conversationId;
+    frame[static_cast<size_t>(RT::HeaderIndex::SeqId)] = seqId;
+
+    // Ids are part of the checksum, so the trailing CRC has to be recomputed
+    frame.back() = Checksum::of(frame.data(), frame.size() - 1);
+}
+
+void FrameBuilderRt::stampTransaction(EncodedFrame& frame, uint8_t conversationId, uint8_t seqId)
+{
+    if (frame.size <= RT::HEADER_SIZE) {
+        throw FrameError("Frame too short to stamp transaction ids");
+    }
+    uint8_t& conversation = frame.bytes[static_cast<size_t>(RT::HeaderIndex::ConversationId)];
+    uint8_t& seq = frame.bytes[static_cast<size_t>(RT::HeaderIndex::SeqId)];
+
+    // Adjust the stored sum instead of walking the frame again
+    frame.checksum.replace(conversation, conversationId).replace(seq, seqId);
+    conversation = conversationId;
+    seq = seqId;
+    frame.bytes[frame.size - 1] = frame.checksum.value();
+}
+
+void FrameBuilderRt::validateValue(int32_t value, RT::RegisterType type) const
 {
     switch (type) {
         case RT::RegisterType::UInt8:
@@ -30,23 +115,23 @@ void FrameBuilderRt::validateValue(int32_t value, RT::RegisterType type)
                 throw FrameError("Value out of range for UInt8 (0-255)");
             }
             break;
-            
+
         case RT::RegisterType::Int16:
             if (value < -32768 || value > 32767) {
                 throw FrameError("Value out of range for Int16 (-32768 to 32767)");
             }
             break;
-            
+
         case RT::RegisterType::UInt16:
             if (value < 0 || value > 65535) {
                 throw FrameError("Value out of range for UInt16 (0-65535)");
             }
             break;
-            
+
         case RT::RegisterType::Int32:
             // No range validation needed for Int32
             break;
-            
+
         case RT::RegisterType::UInt32:
             if (value < 0) {
                 throw FrameError("Value must be non-negative for UInt32");
@@ -56,136 +141,77 @@ void FrameBuilderRt::validateValue(int32_t value, RT::RegisterType type)
         case RT::RegisterType::Float:
             // No range validation needed for Float
             break;
-            
+
         case RT::RegisterType::CharPtr:
             throw FrameError("Cannot validate CharPtr as integer value");
             break;
     }
 }
 
-std::vector<uint8_t> FrameBuilderRt::valueToBytes(int32_t value, RT::RegisterType type) 
+size_t FrameBuilderRt::valueToBytes(int32_t value, RT::RegisterType type, uint8_t* bytes) const
 {
     validateValue(value, type);
-    std::vector<uint8_t> bytes;
-    
+    // Float values arrive as their IEEE-754 bit pattern, so every type is plain little-endian
+    uint32_t bits = static_cast<uint32_t>(value);
+
     switch (type) {
         case RT::RegisterType::UInt8:
-            bytes = {static_cast<uint8_t>(value)};
-            break;
-            
-        case RT::RegisterType::Int16: {
-            // Little-endian: LSB first
-            bytes = {
-                static_cast<uint8_t>(value & 0xFF),           // LSB
-                static_cast<uint8_t>((value >> 8) & 0xFF)     // MSB
-            };
-            break;
-        }
-        case RT::RegisterType::UInt16: {
-            // Little-endian: LSB first
-            bytes = {
-                static_cast<uint8_t>(value & 0xFF),         // LSB
-                static_cast<uint8_t>((value >> 8) & 0xFF)   // MSB
-            };
-            break;
-        }
-            
-        case RT::RegisterType::Int32: {
-            // Little-endian: LSB first
-            bytes = {
-                static_cast<uint8_t>(value & 0xFF),           // LSB
-                static_cast<uint8_t>((value >> 8) & 0xFF),
-                static_cast<uint8_t>((value >> 16) & 0xFF),
-                static_cast<uint8_t>((value >> 24) & 0xFF)    // MSB
-            };
-            break;
-        }
-        case RT::RegisterType::UInt32: {
-            // Little-endian: LSB first
-            bytes = {
-                static_cast<uint8_t>(value & 0xFF),           // LSB
-                static_cast<uint8_t>((value >> 8) & 0xFF),
-                static_cast<uint8_t>((value >> 16) & 0xFF),
-                static_cast<uint8_t>((value >> 24) & 0xFF)    // MSB
-            };
-            break;
-        }
-
-        case RT::RegisterType::Float: {
-            union FloatConverter {
-                float f;
-                uint32_t i;
-            };
-            FloatConverter converter;
-            converter.f = *reinterpret_cast<float*>(&value);
-            uint32_t bits = converter.i;
-            // Little-endian: LSB first
-            bytes = {
-                static_cast<uint8_t>(bits & 0xFF),           // LSB
-                static_cast<uint8_t>((bits >> 8) & 0xFF),
-                static_cast<uint8_t>((bits >> 16) & 0xFF),
-                static_cast<uint8_t>((bits >> 24) & 0xFF)    // MSB
-            };
-            break;
-        }
-            
+            bytes[0] = static_cast<uint8_t>(bits);
+            return 1;
+
+        case RT::RegisterType::Int16:
+        case RT::RegisterType::UInt16:
+            bytes[0] = static_cast<uint8_t>(bits & 0xFF);           // LSB
+            bytes[1] = static_cast<uint8_t>((bits >> 8) & 0xFF);    // MSB
+            return 2;
+
+        case RT::RegisterType::Int32:
+        case RT::RegisterType::UInt32:
+        case RT::RegisterType::Float:
+            bytes[0] = static_cast<uint8_t>(bits & 0xFF);           // LSB
+            bytes[1] = static_cast<uint8_t>((bits >> 8) & 0xFF);
+            bytes[2] = static_cast<uint8_t>((bits >> 16) & 0xFF);
+            bytes[3] = static_cast<uint8_t>((bits >> 24) & 0xFF);   // MSB
+            return 4;
+
         default:
             throw FrameError("Unsupported register type for value conversion");
     }
-    
-    return bytes;
 }
 
-std::vector<uint8_t> FrameBuilderRt::buildReadFrame(uint8_t mscId, RT::RegisterId regId) 
+size_t FrameBuilderRt::valueToBytes(int32_t value, ST_MPC::RegisterType type, uint8_t* bytes) const
 {
-    FrameData frame;
-    
-    // Field 0: [startByte, totalSize, payloadSize, mscId]
-    frame.setStartByte(0xAA);          // startByte always 0xAA
-    frame.setTotalSize(0x12);          // total size: 16 (header) + 2 (payload) = 18 bytes (0x12)
-    frame.setPayloadSize(0x02);        // payload size: 2 bytes
-    frame.addPayloadByte(mscId);       // mscId field (first part)
-    
-    // Field 1: [msgRequestId, msgResponseId, conversationId, senderId]
-    frame.addPayloadByte(0x01);        // msgRequestId
-    frame.addPayloadByte(0x00);        // msgResponseId
-    frame.addPayloadByte(0x01);        // conversationId
-    frame.addPayloadByte(0x01);        // senderId
-    
-    // Field 2: [numBlocks, seqId, commandType, errorCode]
-    frame.addPayloadByte(0x01);        // numBlocks
-    frame.addPayloadByte(0x01);        // seqId
-    frame.addPayloadByte(static_cast<uint8_t>(RT::CommandId::RT_READ));
-    frame.addPayloadByte(static_cast<uint8_t>(RT::ErrorId::NO_ERROR));
-    
-    // Field 3: [futureUse0, futureUse1, futureUse2, endByte]
-    frame.addPayloadByte(0x00);        // futureUse0
-    frame.addPayloadByte(0x00);        // futureUse1
-    frame.addPayloadByte(0x00);        // futureUse2
-    frame.addPayloadByte(0xAA);        // endByte always 0xAA
-    
-    // Payload
-    frame.addPayloadByte(static_cast<uint8_t>(regId));  // Register ID
-
-    /*
-    auto result = frame.complete();
-    std::cout << "FrameBuilder::buildReadFrame()" << std::endl;
-    for (auto byte : result) {
-        std::cout << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte) << " ";
+    switch (type) {
+        case ST_MPC::RegisterType::UInt8:
+            return valueToBytes(value, RT::RegisterType::UInt8, bytes);
+        case ST_MPC::RegisterType::Int16:
+            return valueToBytes(value, RT::RegisterType::Int16, bytes);
+        case ST_MPC::RegisterType::UInt16:
+            return valueToBytes(value, RT::RegisterType::UInt16, bytes);
+        case ST_MPC::RegisterType::Int32:
+        case ST_MPC::RegisterType::UInt32:
+            return valueToBytes(value, RT::RegisterType::Int32, bytes);
+        case ST_MPC::RegisterType::CharPtr:
+            throw FrameError("Cannot convert value to CharPtr type");
+        default:
+            throw FrameError("Unknown ST_MPC register type");
     }
-    std::cout << std::dec << std::endl;
-    return result; 
-    */
+}
 
-    return frame.complete();
+void FrameBuilderRt::encodeReadFrame(EncodedFrame& frame, uint8_t mscId, RT::RegisterId regId) const
+{
+    FrameData data(frame);
+    data.setHeader(READ_HEADER, mscId, 0x12, 0x02);    // header(16) + regId(1) + CRC(1)
+    data.addPayloadByte(static_cast<uint8_t>(regId));
+    data.complete();
 }
 
-std::vector<uint8_t> FrameBuilderRt::buildWriteFrame(uint8_t mscId, RT::RegisterId regId, 
-                                                    int32_t value, RT::RegisterType regType) 
+void FrameBuilderRt::encodeWriteFrame(EncodedFrame& frame, uint8_t mscId, RT::RegisterId regId,
+                                      int32_t value, RT::RegisterType regType) const
 {
-    // auto valueBytes = valueToBytes(value, regType);
-    std::vector<uint8_t> valueBytes = valueToBytes(value, regType);
-    
+    uint8_t valueBytes[4];
+    size_t valueSize = valueToBytes(value, regType, valueBytes);
+
     // Set sizes based on register type
     uint8_t payloadSize;
     uint8_t totalSize;
@@ -209,289 +235,141 @@ std::vector<uint8_t> FrameBuilderRt::buildWriteFrame(uint8_t mscId, RT::Register
             payloadSize = 0x06;  // regId(1) + int32 value(4) + CRC(1)
             totalSize = 0x16;    // header(16) + payload(6)
             break;
-        
+
         default:
             throw FrameError("Unsupported register type for write");
     }
-    
-    FrameData frame;
-    
-    // Header
-    frame.setStartByte(0xAA);
-    frame.setTotalSize(totalSize);
-    frame.setPayloadSize(payloadSize);
-    frame.addPayloadByte(mscId);       // MSC ID first part
-    frame.addPayloadByte(0x0a);        // Message request ID
-    frame.addPayloadByte(0x00);        // Message response ID
-    frame.addPayloadByte(0x63);        // Conversation ID
-    frame.addPayloadByte(0x01);        // Sender ID
-    frame.addPayloadByte(0x01);        // Number of blocks
-    frame.addPayloadByte(0x01);        // Sequence ID
-    frame.addPayloadByte(static_cast<uint8_t>(RT::CommandId::RT_WRITE));
-    frame.addPayloadByte(static_cast<uint8_t>(RT::ErrorId::NO_ERROR));
-    frame.addPayloadByte(0x00);        // Future use 0
-    frame.addPayloadByte(0x00);        // Future use 1
-    frame.addPayloadByte(0x00);        // Future use 2
-    frame.addPayloadByte(0xAA);        // End byte
-    
-    // Payload
-    frame.addPayloadByte(static_cast<uint8_t>(regId));
-    frame.addPayloadBytes(valueBytes);
-
-    return frame.complete();
-}
 
-std::vector<uint8_t> FrameBuilderRt::buildExecuteFrame(uint8_t mscId, RT::ExecuteId execId) 
-{
-    FrameData frame;
-    
-    // Header
-    frame.setStartByte(0xAA);          // Start byte
-    frame.setTotalSize(16 + 1 + 1);    // Total size including payload and CRC
-    frame.setPayloadSize(1);           // Execute command ID
-    frame.addPayloadByte(mscId);       // MSC ID
-    frame.addPayloadByte(0);           // Message request ID
-    frame.addPayloadByte(0);           // Message response ID
-    frame.addPayloadByte(0);           // Conversation ID
-    frame.addPayloadByte(0);           // Sender ID
-    frame.addPayloadByte(1);           // Number of blocks
-    frame.addPayloadByte(0);           // Sequence ID
-    frame.addPayloadByte(static_cast<uint8_t>(RT::CommandId::RT_EXECUTE)); // Command type
-    frame.addPayloadByte(static_cast<uint8_t>(RT::ErrorId::NO_ERROR));     // Error code
-    frame.addPayloadByte(0);           // Future use 0
-    frame.addPayloadByte(0);           // Future use 1
-    frame.addPayloadByte(0);           // Future use 2
-    frame.addPayloadByte(0xAA);        // End byte
-    
-    // Payload
-    frame.addPayloadByte(static_cast<uint8_t>(execId));
-
-    /*
-    auto result = frame.complete();
-    std::cout << "FrameBuilder::buildExecuteFrame()" << std::endl;
-    for (auto byte : result) {
-        std::cout << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte) << " ";
-    }
-    std::cout << std::dec << std::endl;
-
-    return result;
-    */
-
-    return frame.complete();
+    FrameData data(frame);
+    data.setHeader(WRITE_HEADER, mscId, totalSize, payloadSize);
+    data.addPayloadByte(static_cast<uint8_t>(regId));
+    data.addPayloadBytes(valueBytes, valueSize);
+    data.complete();
 }
 
-std::vector<uint8_t> FrameBuilderRt::valueToBytes(int32_t value, ST_MPC::RegisterType type)
+void FrameBuilderRt::encodeExecuteFrame(EncodedFrame& frame, uint8_t mscId, RT::ExecuteId execId) const
 {
-    switch (type) {
-        case ST_MPC::RegisterType::UInt8:
-            validateValue(value, RT::RegisterType::UInt8);
-            return {static_cast<uint8_t>(value)};
-            
-        case ST_MPC::RegisterType::Int16:
-            validateValue(value, RT::RegisterType::Int16);
-            return {
-                static_cast<uint8_t>(value & 0xFF),
-                static_cast<uint8_t>((value >> 8) & 0xFF)
-            };
-            
-        case ST_MPC::RegisterType::UInt16:
-            validateValue(value, RT::RegisterType::UInt16);
-            return {
-                static_cast<uint8_t>(value & 0xFF),
-                static_cast<uint8_t>((value >> 8) & 0xFF)
-            };
-            
-        case ST_MPC::RegisterType::Int32:
-        case ST_MPC::RegisterType::UInt32:
-            validateValue(value, RT::RegisterType::Int32);
-            return {
-                static_cast<uint8_t>(value & 0xFF),
-                static_cast<uint8_t>((value >> 8) & 0xFF),
-                static_cast<uint8_t>((value >> 16) & 0xFF),
-                static_cast<uint8_t>((value >> 24) & 0xFF)
-            };
-            
-        case ST_MPC::RegisterType::CharPtr:
-            throw FrameError("Cannot convert value to CharPtr type");
-            
-        default:
-            throw FrameError("Unknown ST_MPC register type");
-    }
+    FrameData data(frame);
+    data.setHeader(EXECUTE_HEADER, mscId, 16 + 1 + 1, 1);  // Total includes payload and CRC
+    data.addPayloadByte(static_cast<uint8_t>(execId));
+    data.complete();
 }
 
-uint8_t FrameBuilderRt::createFocStartFrame(uint8_t motorId, ST_MPC::CommandId cmd) const 
+uint8_t FrameBuilderRt::createFocStartFrame(uint8_t motorId, ST_MPC::CommandId cmd) const
 {
     // Motor ID in 3 MSB, Command in 5 LSB
     return ((motorId & 0x07) << 5) | (static_cast<uint8_t>(cmd) & 0x1F);
 }
 
-uint8_t FrameBuilderRt::calculateFocCRC(const std::vector<uint8_t>& focFrame) const 
+void FrameBuilderRt::encodeFocFrame(EncodedFrame& frame, const HeaderTemplate& header, uint8_t mscId,
+                                    ST_MPC::CommandId cmd, const uint8_t* payload,
+                                    uint8_t payloadLength) const
 {
-    uint16_t sum = 0;
-    for (const auto& byte : focFrame) {
-        sum += byte;
-    }
-    return static_cast<uint8_t>((sum & 0xFF) + (sum >> 8));
+    // FOC frame: [startFrame, payloadLength, payload, focCrc] wrapped in an RT frame
+    uint8_t focSize = 2 + payloadLength + 1;
+    uint8_t startFrame = createFocStartFrame(mscId, cmd);
+
+    FrameData data(frame);
+    data.setHeader(header, mscId, 16 + focSize + 1, focSize + 1);  // header + FOC frame + RT CRC
+
+    data.addPayloadByte(startFrame);
+    data.addPayloadByte(payloadLength);
+    data.addPayloadBytes(payload, payloadLength);
+    data.addPayloadByte(Checksum::Additive().add(startFrame).add(payloadLength).add(payload, payloadLength).value());
+    data.complete();
 }
 
-std::vector<uint8_t> FrameBuilderRt::buildFocPayload(uint8_t startFrame, uint8_t payloadLength, 
-                                                    std::vector<uint8_t> payload) const 
+void FrameBuilderRt::encodeFocReadFrame(EncodedFrame& frame, uint8_t mscId, ST_MPC::RegisterId regId) const
 {
-    std::vector<uint8_t> focFrame;
-    focFrame.push_back(startFrame);
-    focFrame.push_back(payloadLength);
-    focFrame.insert(focFrame.end(), payload.begin(), payload.end());
-    
-    // Calculate and append FOC CRC
-    focFrame.push_back(calculateFocCRC(focFrame));
-    return focFrame;
+    uint8_t payload[] = {static_cast<uint8_t>(regId)};
+    encodeFocFrame(frame, FOC_READ_HEADER, mscId, ST_MPC::CommandId::GetRegister, payload, 1);
 }
 
-std::vector<uint8_t> FrameBuilderRt::buildFocReadFrame(uint8_t mscId, ST_MPC::RegisterId regId) 
+void FrameBuilderRt::encodeFocWriteFrame(EncodedFrame& frame, uint8_t mscId, ST_MPC::RegisterId regId,
+                                         int32_t value, ST_MPC::RegisterType regType) const
 {
-    // Create FOC frame components
-    uint8_t startFrame = createFocStartFrame(mscId, ST_MPC::CommandId::GetRegister);
-    std::vector<uint8_t> regPayload = {static_cast<uint8_t>(regId)};
-    auto focPayload = buildFocPayload(startFrame, 0x01, regPayload);
-
-    // Build RT frame containing FOC payload
-    uint8_t commandId = static_cast<uint8_t>(RT::CommandId::FOC_COMMAND);
-    uint8_t errorId = static_cast<uint8_t>(RT::ErrorId::NO_ERROR);
-    FrameData frame;
-    frame.setStartByte(0xAA);
-    frame.setTotalSize(16 + focPayload.size() + 1); // header + FOC payload + RT CRC
-    frame.setPayloadSize(focPayload.size()+1);      // payload size + CRC
-    frame.addPayloadByte(mscId);                    // MSC ID first part
-    frame.addPayloadByte(0x0c);                     // Message request ID
-    frame.addPayloadByte(0x00);                     // Message response ID
-    frame.addPayloadByte(0x63);                     // Conversation ID
-    frame.addPayloadByte(0x01);                     // Sender ID
-    frame.addPayloadByte(0x01);                     // Number of blocks
-    frame.addPayloadByte(0x01);                     // Sequence ID
-    frame.addPayloadByte(commandId);                // commandId
-    frame.addPayloadByte(errorId);                  // errorId
-    frame.addPayloadByte(0x00);                     // Future use 0
-    frame.addPayloadByte(0x00);                     // Future use 1
-    frame.addPayloadByte(0x00);                     // Future use 2
-    frame.addPayloadByte(0xAA);                     // End byte
-
-    // Add FOC payload
-    for (const auto& byte : focPayload) {
-        frame.addPayloadByte(byte);
-    }
-
-    /*
-    auto result = frame.complete();
-    std::cout << "FrameBuilder::buildFocReadFrame()" << std::endl;
-    for (auto byte : result) {
-        std::cout << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte) << " ";
-    }
-    std::cout << std::dec << std::endl;
-
-    return result;
-    */
+    // Register ID followed by value bytes
+    uint8_t payload[5] = {static_cast<uint8_t>(regId)};
+    size_t valueSize = valueToBytes(value, regType, payload + 1);
+    encodeFocFrame(frame, FOC_WRITE_HEADER, mscId, ST_MPC::CommandId::SetRegister,
+                   payload, static_cast<uint8_t>(1 + valueSize));
+}
 
-   return frame.complete();
+void FrameBuilderRt::encodeFocExecuteFrame(EncodedFrame& frame, uint8_t mscId, ST_MPC::ExecuteId execId) const
+{
+    uint8_t payload[] = {static_cast<uint8_t>(execId)};
+    encodeFocFrame(frame, FOC_EXECUTE_HEADER, mscId, ST_MPC::CommandId::Execute, payload, 1);
 }
 
-std::vector<uint8_t> FrameBuilderRt::buildFocWriteFrame(uint8_t mscId, ST_MPC::RegisterId regId, 
-                                                       int32_t value, ST_MPC::RegisterType regType) 
+void FrameBuilderRt::encodeBatchReadFrame(EncodedFrame& frame, uint8_t mscId,
+                                          std::span<const BatchItem> items) const
 {
-    // Create FOC frame components
-    uint8_t startFrame = createFocStartFrame(mscId, ST_MPC::CommandId::SetRegister);
-    
-    // Convert value to bytes according to register type
-    auto valueBytes = valueToBytes(value, regType);
-    
-    // Build FOC payload: register ID followed by value bytes
-    std::vector<uint8_t> regPayload = {static_cast<uint8_t>(regId)};
-    regPayload.insert(regPayload.end(), valueBytes.begin(), valueBytes.end());
-    
-    auto focPayload = buildFocPayload(startFrame, regPayload.size(), regPayload);
-    
-    // Build RT frame containing FOC payload
-    uint8_t commandId = static_cast<uint8_t>(RT::CommandId::FOC_COMMAND);
-    uint8_t errorId = static_cast<uint8_t>(RT::ErrorId::NO_ERROR);
-    FrameData frame;
-    frame.setStartByte(0xAA);
-    frame.setTotalSize(16 + focPayload.size() + 1); // header + FOC payload + RT CRC
-    frame.setPayloadSize(focPayload.size() + 1);    // payload size + CRC
-    frame.addPayloadByte(mscId);                    // MSC ID first part
-    frame.addPayloadByte(0x0d);                     // Message request ID
-    frame.addPayloadByte(0x00);                     // Message response ID
-    frame.addPayloadByte(0x63);                     // Conversation ID
-    frame.addPayloadByte(0x01);                     // Sender ID
-    frame.addPayloadByte(0x01);                     // Number of blocks
-    frame.addPayloadByte(0x01);                     // Sequence ID
-    frame.addPayloadByte(commandId);                // commandId
-    frame.addPayloadByte(errorId);                  // errorId
-    frame.addPayloadByte(0x00);                     // Future use 0
-    frame.addPayloadByte(0x00);                     // Future use 1
-    frame.addPayloadByte(0x00);                     // Future use 2
-    frame.addPayloadByte(0xAA);                     // End byte
-
-    // Add FOC payload
-    for (const auto& byte : focPayload) {
-        frame.addPayloadByte(byte);
+    if (items.empty() || items.size() > RT::MAX_BATCH_REGISTERS) {
+        throw FrameError("Batch read needs 1-" + std::to_string(RT::MAX_BATCH_REGISTERS) + " registers");
     }
 
-    /*
-    auto result =  frame.complete();
-    std::cout << "FrameBuilder::buildFocWriteFrame()" << std::endl;
-    for (auto byte : result) {
-        std::cout << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte) << " ";
+    // Payload: [count, (source, registerId) * count, CRC]
+    uint8_t count = static_cast<uint8_t>(items.size());
+    uint8_t payloadSize = 1 + 2 * count + 1;
+
+    FrameData data(frame);
+    data.setHeader(BATCH_READ_HEADER, mscId, 16 + payloadSize, payloadSize);
+    data.setHeaderField(RT::HeaderIndex::NumBlocks, count);
+    data.addPayloadByte(count);
+    for (const auto& item : items) {
+        data.addPayloadByte(static_cast<uint8_t>(item.source));
+        data.addPayloadByte(item.registerId);
     }
-    std::cout << std::dec << std::endl;
+    data.complete();
+}
+
+std::vector<uint8_t> FrameBuilderRt::buildReadFrame(uint8_t mscId, RT::RegisterId regId)
+{
+    EncodedFrame frame;
+    encodeReadFrame(frame, mscId, regId);
+    return toVector(frame);
+}
 
-    return result;
-    */
+std::vector<uint8_t> FrameBuilderRt::buildWriteFrame(uint8_t mscId, RT::RegisterId regId,
+                                                    int32_t value, RT::RegisterType regType)
+{
+    EncodedFrame frame;
+    encodeWriteFrame(frame, mscId, regId, value, regType);
+    return toVector(frame);
+}
 
-    return frame.complete();
+std::vector<uint8_t> FrameBuilderRt::buildExecuteFrame(uint8_t mscId, RT::ExecuteId execId)
+{
+    EncodedFrame frame;
+    encodeExecuteFrame(frame, mscId, execId);
+    return toVector(frame);
 }
 
-std::vector<uint8_t> FrameBuilderRt::buildFocExecuteFrame(uint8_t mscId, ST_MPC::ExecuteId execId) 
+std::vector<uint8_t> FrameBuilderRt::buildFocReadFrame(uint8_t mscId, ST_MPC::RegisterId regId)
 {
-    // Create FOC frame components
-    uint8_t startFrame = createFocStartFrame(mscId, ST_MPC::CommandId::Execute);
-    std::vector<uint8_t> execPayload = {static_cast<uint8_t>(execId)};
-    auto focPayload = buildFocPayload(startFrame, 0x01, execPayload);
-    
-    // Build RT frame containing FOC payload
-    uint8_t commandId = static_cast<uint8_t>(RT::CommandId::FOC_COMMAND);
-    uint8_t errorId = static_cast<uint8_t>(RT::ErrorId::NO_ERROR);
-    FrameData frame;
-    frame.setStartByte(0xAA);
-    frame.setTotalSize(16 + focPayload.size() + 1); // header + FOC payload + RT CRC
-    frame.setPayloadSize(focPayload.size() + 1);    // payload size + CRC
-    frame.addPayloadByte(mscId);                    // MSC ID first part
-    frame.addPayloadByte(0x0e);                     // Message request ID
-    frame.addPayloadByte(0x00);                     // Message response ID
-    frame.addPayloadByte(0x63);                     // Conversation ID
-    frame.addPayloadByte(0x01);                     // Sender ID
-    frame.addPayloadByte(0x01);                     // Number of blocks
-    frame.addPayloadByte(0x01);                     // Sequence ID
-    frame.addPayloadByte(commandId);                // commandId
-    frame.addPayloadByte(errorId);                  // errorId
-    frame.addPayloadByte(0x00);                     // Future use 0
-    frame.addPayloadByte(0x00);                     // Future use 1
-    frame.addPayloadByte(0x00);                     // Future use 2
-    frame.addPayloadByte(0xAA);                     // End byte
-
-    // Add FOC payload
-    for (const auto& byte : focPayload) {
-        frame.addPayloadByte(byte);
-    }
+    EncodedFrame frame;
+    encodeFocReadFrame(frame, mscId, regId);
+    return toVector(frame);
+}
 
-    /*
-    auto result = frame.complete();
-    std::cout << "FrameBuilderRt::buildFocExecuteFrame()" << std::endl;
-    for (auto byte : result) {
-        std::cout << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte) << " ";
-    }   
+std::vector<uint8_t> FrameBuilderRt::buildFocWriteFrame(uint8_t mscId, ST_MPC::RegisterId regId,
+                                                       int32_t value, ST_MPC::RegisterType regType)
+{
+    EncodedFrame frame;
+    encodeFocWriteFrame(frame, mscId, regId, value, regType);
+    return toVector(frame);
+}
 
-    std::cout << std::dec << std::endl;
+std::vector<uint8_t> FrameBuilderRt::buildFocExecuteFrame(uint8_t mscId, ST_MPC::ExecuteId execId)
+{
+    EncodedFrame frame;
+    encodeFocExecuteFrame(frame, mscId, execId);
+    return toVector(frame);
+}
 
-    return result;
-    */
-    return frame.complete();
-}
\ No newline at end of file
+std::vector<uint8_t> FrameBuilderRt::buildBatchReadFrame(uint8_t mscId, std::span<const BatchItem> items)
+{
+    EncodedFrame frame;
+    encodeBatchReadFrame(frame, mscId, items);
+    return toVector(frame);
+}
@@ -3,61 +3,99 @@
 #define FRAME_BUILDER_RT_H
 
 #include "RtDefinitions.h"
+#include "Checksum.h"
 #include "StMpcDefinitions.h"
+#include <array>
 #include <vector>
+#include <span>
 #include <cstdint>
 #include <stdexcept>
 #include <string>
 #include <iostream>
 #include <iomanip>
 
-class FrameBuilderRt 
+class FrameBuilderRt
 {
 public:
-    class FrameError : public std::runtime_error 
+    class FrameError : public std::runtime_error
     {
     public:
         explicit FrameError(const std::string& msg) : std::runtime_error(msg) {}
     };
 
+    static constexpr size_t MAX_FRAME_SIZE = 64;
+
+    // Fixed-capacity frame used by the allocation-free encode path
+    struct EncodedFrame
+    {
+        std::array<uint8_t, MAX_FRAME_SIZE> bytes{};
+        uint8_t size{0};
+        Checksum::Additive checksum;    // Over everything before the CRC
+
+        std::span<const uint8_t> view() const { return {bytes.data(), size}; }
+    };
+
+    struct BatchItem
+    {
+        RT::BatchSource source;
+        uint8_t registerId;
+    };
+
+    // Encode into a caller-owned frame; no heap allocation
+    void encodeReadFrame(EncodedFrame& frame, uint8_t mscId, RT::RegisterId regId) const;
+    void encodeWriteFrame(EncodedFrame& frame, uint8_t mscId, RT::RegisterId regId,
+                          int32_t value, RT::RegisterType regType) const;
+    void encodeExecuteFrame(EncodedFrame& frame, uint8_t mscId, RT::ExecuteId execId) const;
+    void encodeFocReadFrame(EncodedFrame& frame, uint8_t mscId, ST_MPC::RegisterId regId) const;
+    void encodeFocWriteFrame(EncodedFrame& frame, uint8_t mscId, ST_MPC::RegisterId regId,
+                             int32_t value, ST_MPC::RegisterType regType) const;
+    void encodeFocExecuteFrame(EncodedFrame& frame, uint8_t mscId, ST_MPC::ExecuteId execId) const;
+    void encodeBatchReadFrame(EncodedFrame& frame, uint8_t mscId, std::span<const BatchItem> items) const;
+
     std::vector<uint8_t> buildReadFrame(uint8_t mscId, RT::RegisterId regId);
-    std::vector<uint8_t> buildWriteFrame(uint8_t mscId, RT::RegisterId regId, 
+    std::vector<uint8_t> buildWriteFrame(uint8_t mscId, RT::RegisterId regId,
                                         int32_t value, RT::RegisterType regType);
     std::vector<uint8_t> buildExecuteFrame(uint8_t mscId, RT::ExecuteId execId);
     std::vector<uint8_t> buildFocReadFrame(uint8_t mscId, ST_MPC::RegisterId regId);
-    std::vector<uint8_t> buildFocWriteFrame(uint8_t mscId, ST_MPC::RegisterId regId, 
+    std::vector<uint8_t> buildFocWriteFrame(uint8_t mscId, ST_MPC::RegisterId regId,
                                            int32_t value, ST_MPC::RegisterType regType);
     std::vector<uint8_t> buildFocExecuteFrame(uint8_t mscId, ST_MPC::ExecuteId execId);
+    std::vector<uint8_t> buildBatchReadFrame(uint8_t mscId, std::span<const BatchItem> items);
 
+    // Tag a built frame with conversation/sequence ids so a pipelined reply can be matched
+    static void stampTransaction(std::vector<uint8_t>& frame, uint8_t conversationId, uint8_t seqId);
+    static void stampTransaction(EncodedFrame& frame, uint8_t conversationId, uint8_t seqId);
+
+    // Constant header bytes with their byte sum, built at compile time
+    struct HeaderTemplate
+    {
+        std::array<uint8_t, RT::HEADER_SIZE> bytes;
+        uint16_t sum;
+    };
 
 private:
-    class FrameData 
+
+    class FrameData
     {
     public:
-        void setStartByte(uint8_t byte) { frame.push_back(byte); }
-        void setTotalSize(uint8_t size) { frame.push_back(size); }
-        void setPayloadSize(uint8_t size) { frame.push_back(size); }
-        void addPayloadByte(uint8_t byte) { frame.push_back(byte); }
-        void addPayloadBytes(const std::vector<uint8_t>& bytes);
-        std::vector<uint8_t> complete();
+        explicit FrameData(EncodedFrame& frame) : frame(frame) { frame.size = 0; frame.checksum = {}; }
+        void setHeader(const HeaderTemplate& header, uint8_t mscId, uint8_t totalSize, uint8_t payloadSize);
+        void setHeaderField(RT::HeaderIndex index, uint8_t value);
+        void addPayloadByte(uint8_t byte);
+        void addPayloadBytes(const uint8_t* bytes, size_t count);
+        void complete();
 
     private:
-        std::vector<uint8_t> frame;
-        uint8_t calculateCRC() const;
+        EncodedFrame& frame;
     };
-    std::vector<uint8_t> focPayload;
 
-    std::vector<uint8_t> valueToBytes(int32_t value, RT::RegisterType type);
-    std::vector<uint8_t> valueToBytes(int32_t value, ST_MPC::RegisterType type);
-    void validateValue(int32_t value, RT::RegisterType type);
+    static std::vector<uint8_t> toVector(const EncodedFrame& frame);
+    size_t valueToBytes(int32_t value, RT::RegisterType type, uint8_t* bytes) const;
+    size_t valueToBytes(int32_t value, ST_MPC::RegisterType type, uint8_t* bytes) const;
+    void validateValue(int32_t value, RT::RegisterType type) const;
     uint8_t createFocStartFrame(uint8_t motorId, ST_MPC::CommandId cmd) const;
-    std::vector<uint8_t> buildFocPayload(uint8_t startFrame, uint8_t payloadLength, 
-                                        std::vector<uint8_t> payload) const;
-    uint8_t calculateFocCRC(const std::vector<uint8_t>& focFrame) const;
-
-
-
-
+    void encodeFocFrame(EncodedFrame& frame, const HeaderTemplate& header, uint8_t mscId,
+                        ST_MPC::CommandId cmd, const uint8_t* payload, uint8_t payloadLength) const;
 };
 
-#endif // FRAME_BUILDER_RT_H
\ No newline at end of file
+#endif // FRAME_BUILDER_RT_H
@@ -1,427 +1,378 @@
 #include "FrameInterpreterRt.h"
+#include "Checksum.h"
+#include "RegisterTableRt.h"
+#include <bit>
 #include <sstream>
 #include <iomanip>
 #include <iostream>
 
-void FrameInterpreterRt::printResponse(const std::vector<uint8_t>& response) 
+namespace {
+
+constexpr size_t HEADER_SIZE = RT::HEADER_SIZE;
+
+uint8_t headerField(std::span<const uint8_t> response, RT::HeaderIndex index)
 {
-    for (const auto& byte : response) {
-        std::cout << byteToHex(byte) << " ";
-    }
-    std::cout << std::endl;
+    return response[static_cast<size_t>(index)];
 }
 
-std::string FrameInterpreterRt::interpretResponse(const std::vector<uint8_t>& response) 
+uint32_t readLe(const uint8_t* bytes, size_t count)
 {
-    if (response.size() < 16) {
-        return "Error: Invalid response size";
+    uint32_t value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        value |= static_cast<uint32_t>(bytes[i]) << (8 * i);  // Little-endian
     }
+    return value;
+}
+
+} // namespace
 
-    ResponseInfo info = parseResponse(response);
-    
-    // Handle bad CRC first
-    if (!info.validCRC) {
-        return "Error: Invalid CRC";
+void FrameInterpreterRt::printResponse(const std::vector<uint8_t>& response)
+{
+    for (const auto& byte : response) {
+        std::cout << byteToHex(byte) << " ";
     }
+    std::cout << std::endl;
+}
 
-    // Handle error codes
-    if (info.header.errorCode != static_cast<uint8_t>(RT::ErrorId::NO_ERROR)) {
-        auto it = errorCodes.find(static_cast<RT::ErrorId>(info.header.errorCode));
-        return "Error: " + (it != errorCodes.end() ? it->second : "Unknown error");
+FrameInterpreterRt::Decoded FrameInterpreterRt::decode(std::span<const uint8_t> response)
+{
+    Decoded decoded = decodeHeader(response);
+    if (!decoded.ok()) {
+        return decoded;
     }
 
-    // Route to appropriate handler based on command type
-    switch (static_cast<RT::CommandId>(info.header.commandType)) {
+    switch (decoded.command) {
         case RT::CommandId::RT_READ_REPLY:
-            return handleRtRead(info);
+            return decodeRtRead(response, RT::RegisterType::UInt8);
         case RT::CommandId::RT_WRITE_REPLY:
-            return handleRtWrite(info);
         case RT::CommandId::RT_EXECUTE_REPLY:
-            return handleRtExecute(info);
+        case RT::CommandId::RT_BATCH_READ_REPLY:    // Entries need the request; see decodeBatch()
+            return decoded;
         case RT::CommandId::FOC_COMMAND_REPLY:
-            return handleFocCommand(info);
+            return decodeFoc(response, std::nullopt);
         default:
-            return "Error: Unknown command type";
+            decoded.error = DecodeError::UnknownCommand;
+            return decoded;
     }
 }
 
-std::string FrameInterpreterRt::interpretResponse(const std::vector<uint8_t>& response, RT::RegisterType type) 
+FrameInterpreterRt::Decoded FrameInterpreterRt::decode(std::span<const uint8_t> response, RT::RegisterType type)
 {
-    if (response.size() < 16) {
-        return "Error: Invalid response size";
-    }
-
-    ResponseInfo info = parseResponse(response);
-    
-    if (!info.validCRC) {
-        return "Error: Invalid CRC";
+    Decoded decoded = decodeHeader(response);
+    if (decoded.ok() && decoded.command == RT::CommandId::RT_READ_REPLY) {
+        return decodeRtRead(response, type);
     }
+    return decoded.ok() ? decode(response) : decoded;
+}
 
-    if (info.header.commandType == static_cast<uint8_t>(RT::CommandId::RT_READ_REPLY)) {
-        return handleRtRead(info, type);
+FrameInterpreterRt::Decoded FrameInterpreterRt::decode(std::span<const uint8_t> response, ST_MPC::RegisterType type)
+{
+    Decoded decoded = decodeHeader(response);
+    if (decoded.ok() && decoded.command == RT::CommandId::FOC_COMMAND_REPLY) {
+        return decodeFoc(response, type);
     }
-
-    return interpretResponse(response);
+    return decoded.ok() ? decode(response) : decoded;
 }
 
-std::string FrameInterpreterRt::interpretResponse(const std::vector<uint8_t>& response, ST_MPC::RegisterType type) 
+FrameInterpreterRt::Decoded FrameInterpreterRt::decodeHeader(std::span<const uint8_t> response)
 {
-    if (response.size() < 16) {
-        return "Error: Invalid response size";
+    Decoded decoded;
+    if (response.size() < HEADER_SIZE) {
+        decoded.error = DecodeError::InvalidSize;
+        return decoded;
     }
 
-    ResponseInfo info = parseResponse(response);
-    
-    if (!info.validCRC) {
-        return "Error: Invalid CRC";
+    decoded.command = static_cast<RT::CommandId>(headerField(response, RT::HeaderIndex::CommandType));
+    if (!crcExempt(response) && !validateCrc(response)) {
+        decoded.error = DecodeError::InvalidCrc;
+        return decoded;
     }
 
-    if (info.header.commandType == static_cast<uint8_t>(RT::CommandId::FOC_COMMAND_REPLY)) {
-        return handleFocCommand(info, type);
+    uint8_t errorCode = headerField(response, RT::HeaderIndex::ErrorCode);
+    if (errorCode != static_cast<uint8_t>(RT::ErrorId::NO_ERROR)) {
+        decoded.error = DecodeError::DeviceError;
+        decoded.code = errorCode;
     }
-
-    return interpretResponse(response);
+    return decoded;
 }
 
-FrameInterpreterRt::ResponseInfo FrameInterpreterRt::parseResponse(const std::vector<uint8_t>& response) 
+bool FrameInterpreterRt::crcExempt(std::span<const uint8_t> response)
 {
-    ResponseInfo info;
-    info.header = parseHeader(response);
-
-    // Extract payload for normal cases
-    if (response.size() > 16) {
-        info.payload.assign(response.begin() + 16, response.end() - 1);
-        info.crc = response.back();
-    }
-
-    if ((info.header.commandType == static_cast<uint8_t>(RT::CommandId::RT_READ_REPLY)) && 
-    info.payload[0] == static_cast<uint8_t>(RT::RegisterId::GIT_VERSION)) {
-        info.validCRC = true;
-    } else if (info.header.commandType == static_cast<uint8_t>(RT::CommandId::RT_WRITE_REPLY)) {    
-        info.validCRC = true;
-    } 
-    else {
-        info.validCRC = validateCRC(response);
+    // Write replies are header-only and GIT_VERSION replies carry no valid CRC
+    auto command = static_cast<RT::CommandId>(headerField(response, RT::HeaderIndex::CommandType));
+    if (command == RT::CommandId::RT_WRITE_REPLY) {
+        return true;
     }
-    return info;
+    return command == RT::CommandId::RT_READ_REPLY && response.size() > HEADER_SIZE &&
+           response[HEADER_SIZE] == static_cast<uint8_t>(RT::RegisterId::GIT_VERSION);
 }
 
-FrameInterpreterRt::Header FrameInterpreterRt::parseHeader(const std::vector<uint8_t>& response) 
+bool FrameInterpreterRt::validateCrc(std::span<const uint8_t> frame)
 {
-    Header header;
-    
-    // Field 0
-    header.startByte = response[0];
-    header.totalSize = response[1];
-    header.payloadSize = response[2];
-    header.mscId = response[3];
-    
-    // Field 1
-    header.msgRequestId = response[4];
-    header.msgResponseId = response[5];
-    header.conversationId = response[6];
-    header.senderId = response[7];
-    
-    // Field 2
-    header.numBlocks = response[8];
-    header.seqId = response[9];
-    header.commandType = response[10];
-    header.errorCode = response[11];
-    
-    // Field 3
-    header.futureUse0 = response[12];
-    header.futureUse1 = response[13];
-    header.futureUse2 = response[14];
-    header.endByte = response[15];
-    
-    return header;
+    return frame.size() >= 2 && Checksum::verify(frame);
 }
 
-bool FrameInterpreterRt::validateCRC(const std::vector<uint8_t>& frame) const 
+FrameInterpreterRt::Decoded FrameInterpreterRt::decodeRtRead(std::span<const uint8_t> response, RT::RegisterType type)
 {
-    if (frame.size() < 2) return false;
-    
-    uint16_t sum = 0;
-    for (size_t i = 0; i < frame.size() - 1; ++i) {
-        sum += frame[i];
+    // Payload: [regId, value..., CRC]
+    Decoded decoded;
+    decoded.command = RT::CommandId::RT_READ_REPLY;
+    if (response.size() <= HEADER_SIZE + 1) {
+        decoded.error = DecodeError::EmptyPayload;
+        return decoded;
     }
-    
-    uint8_t calculated_crc = static_cast<uint8_t>((sum & 0xFF) + (sum >> 8));
-    return calculated_crc == frame.back();
-}
-
-bool FrameInterpreterRt::validateWriteReplyCRC(const std::vector<uint8_t>& frame) const 
-{
-    if (frame.size() != 16) return false;
 
-    // Create modified frame with endByte as 0xAA and original endByte as CRC
-    std::vector<uint8_t> modifiedFrame = frame;
-    uint8_t originalCrc = frame[15];
-    modifiedFrame[15] = 0xAA;
-    modifiedFrame.push_back(originalCrc);
-
-    return validateCRC(modifiedFrame);
+    auto valueBytes = response.subspan(HEADER_SIZE + 1, response.size() - HEADER_SIZE - 2);
+    decoded.error = readValue(valueBytes, type, decoded.value);
+    return decoded;
 }
 
-bool FrameInterpreterRt::validateFocCRC(const std::vector<uint8_t>& focFrame) const 
+FrameInterpreterRt::Decoded FrameInterpreterRt::decodeFoc(std::span<const uint8_t> response,
+                                                         std::optional<ST_MPC::RegisterType> type)
 {
-    if (focFrame.size() < 2) return false;
-    
-    uint16_t sum = 0;
-    for (size_t i = 0; i < focFrame.size() - 1; ++i) {
-        sum += focFrame[i];
+    // Payload: [mscId, errorCode, ack, focPayloadLength, focPayload..., focCrc, CRC]
+    Decoded decoded;
+    decoded.command = RT::CommandId::FOC_COMMAND_REPLY;
+    if (response.size() < HEADER_SIZE + 5) {
+        decoded.error = DecodeError::InvalidFocSize;
+        return decoded;
     }
-    
-    uint8_t calculated_crc = static_cast<uint8_t>((sum & 0xFF) + (sum >> 8));
-    return calculated_crc == focFrame.back();
-}
+    auto payload = response.subspan(HEADER_SIZE, response.size() - HEADER_SIZE - 1);
 
-std::string FrameInterpreterRt::handleRtRead(const ResponseInfo& info, RT::RegisterType type) 
-{
-    if (info.payload.empty()) {
-        return "Error: Empty read response";
-    } else if (info.header.commandType != static_cast<uint8_t>(RT::CommandId::RT_READ_REPLY)) {
-        return "Error: Unexpected command type";
-    } else if (info.header.errorCode != static_cast<uint8_t>(RT::ErrorId::NO_ERROR)) {
-        auto it = errorCodes.find(static_cast<RT::ErrorId>(info.header.errorCode));
-        return "Error: " + (it != errorCodes.end() ? it->second : "Unknown error");
-    } else {
-        return "Success: " + formatValue(info.payload, type);
+    if (payload[1] != static_cast<uint8_t>(RT::ErrorId::NO_ERROR)) {
+        decoded.error = DecodeError::DeviceError;
+        decoded.code = payload[1];
+        return decoded;
     }
-}
 
-std::string FrameInterpreterRt::handleRtWrite(const ResponseInfo& info) 
-{
-    if (info.header.commandType != static_cast<uint8_t>(RT::CommandId::RT_WRITE_REPLY)) {
-        return "Error: Unexpected command type";
-    } else if (info.header.errorCode != static_cast<uint8_t>(RT::ErrorId::NO_ERROR)) {
-        auto it = errorCodes.find(static_cast<RT::ErrorId>(info.header.errorCode));
-        return "Error: " + (it != errorCodes.end() ? it->second : "Unknown error");
-    } else {
-        return "Success: Write command executed";
+    if (!validateCrc(payload.subspan(2))) {
+        decoded.error = DecodeError::InvalidFocCrc;
+        return decoded;
     }
 
-}
-
-std::string FrameInterpreterRt::handleRtExecute(const ResponseInfo& info) 
-{
-    if (info.header.commandType == static_cast<uint8_t>(RT::CommandId::RT_EXECUTE_REPLY)) {
-        if (info.header.errorCode == static_cast<uint8_t>(RT::ErrorId::NO_ERROR)) {
-            return "Success: Execute command executed";
+    uint8_t ack = payload[2];
+    if (ack != static_cast<uint8_t>(ST_MPC::AckStatus::Success)) {
+        if (ack != static_cast<uint8_t>(ST_MPC::AckStatus::Failure)) {
+            decoded.error = DecodeError::InvalidFocAck;
+            decoded.code = ack;
         } else {
-            auto it = errorCodes.find(static_cast<RT::ErrorId>(info.header.errorCode));
-            return "Error: " + (it != errorCodes.end() ? it->second : "Unknown error");
+            decoded.error = DecodeError::FocNack;
+            decoded.code = payload.size() > 4 ? payload[4] : 0;
         }
-    } else {
-        return "Error: Execute command failed";
+        return decoded;
     }
-}
 
-std::string FrameInterpreterRt::handleFocCommand(const ResponseInfo& info, std::optional<ST_MPC::RegisterType> type) 
-{
-    // Debug: print the entire foc frame
-    /*
-    std::cout << "FrameInterpreterRt::handleFocCommand()" << std::endl;
-    for (const auto& byte : info.payload) {
-        std::cout << byteToHex(byte) << " ";
+    uint8_t focPayloadLength = payload[3];
+    if (focPayloadLength == 0) {
+        return decoded;     // Write/execute acknowledge
+    }
+    if (payload.size() < 4u + focPayloadLength + 1) {
+        decoded.error = DecodeError::InvalidFocSize;
+        return decoded;
     }
-    std::cout << std::endl;
-    */
 
-    // Extract FOC frame: [ack, focPayloadLength, focPayload, focCrc]
-    if (info.payload.size() < 4) {  // Minimum FOC frame size
-        return "Error: Invalid FOC frame size";
+    auto focPayload = payload.subspan(4, focPayloadLength);
+    if (type.has_value()) {
+        decoded.error = readValue(focPayload, RegisterTable::toRtType(type.value()), decoded.value);
+    } else {
+        decoded.value = focPayload;
     }
-    uint8_t mscId = info.payload[0];
-    uint8_t errorCode = info.payload[1];
-    uint8_t ack = info.payload[2];
-    uint8_t focPayloadLength = info.payload[3];
-    std::vector<uint8_t> focFrame(info.payload.begin() + 2, info.payload.end());
-    
-    // Print mscId and error code (if any)
-    std::cout << "mscId: " << byteToHex(mscId) << std::endl;
-    auto it = errorCodes.find(static_cast<RT::ErrorId>(errorCode));
-    if (it->first != RT::ErrorId::NO_ERROR) {
-        std::cout << "Error: " << it->second << std::endl;
-    } else if (it == errorCodes.end()) {
-        std::cout << "Error: Unknown error code: " << byteToHex(errorCode) << std::endl;
+    return decoded;
+}
+
+FrameInterpreterRt::Decoded FrameInterpreterRt::decodeBatch(std::span<const uint8_t> response,
+                                                            std::span<BatchEntry> entries)
+{
+    // Payload: [count, (status, length, valueBytes) * count, CRC]
+    Decoded decoded = decodeHeader(response);
+    if (!decoded.ok()) {
+        return decoded;
     }
-    // Validate FOC CRC
-    if (!validateFocCRC(focFrame)) {
-        return "Error: Invalid FOC CRC";
+    if (decoded.command != RT::CommandId::RT_BATCH_READ_REPLY || response.size() <= HEADER_SIZE + 1) {
+        decoded.error = DecodeError::BatchMismatch;
+        return decoded;
     }
 
-    // Check FOC frame validity
-    if (ack != static_cast<uint8_t>(ST_MPC::AckStatus::Success)) {
-        if (ack != static_cast<uint8_t>(ST_MPC::AckStatus::Failure)) {
-            return "Error: Invalid FOC ack: " + byteToHex(ack);
+    auto payload = response.subspan(HEADER_SIZE, response.size() - HEADER_SIZE - 1);
+    if (payload[0] != entries.size()) {
+        decoded.error = DecodeError::BatchMismatch;
+        return decoded;
+    }
 
-        } else {
-            uint8_t errorCode = info.payload[4];
-            auto it = errorCodesFoc.find(static_cast<ST_MPC::AckErrorId>(errorCode));
-            if (it != errorCodesFoc.end()) {
-                return "Error: " + it->second;
-            } else {
-                return "Error: Unknown FOC error code: " + byteToHex(errorCode);
-            }
+    size_t offset = 1;
+    for (auto& entry : entries) {
+        if (offset + 2 > payload.size() || offset + 2 + payload[offset + 1] > payload.size()) {
+            decoded.error = DecodeError::BatchMismatch;
+            return decoded;
         }
+        entry.status = payload[offset];
+        entry.bytes = payload.subspan(offset + 2, payload[offset + 1]);
+        offset += 2 + entry.bytes.size();
     }
+    return decoded;
+}
 
-    // If it's a write response, we're done
-    if (focPayloadLength == 0) {
-        return "Success: FOC command executed";
+FrameInterpreterRt::Decoded FrameInterpreterRt::decodeBatchEntry(const BatchEntry& entry, RT::RegisterType type)
+{
+    Decoded decoded;
+    if (entry.status != static_cast<uint8_t>(RT::ErrorId::NO_ERROR)) {
+        decoded.error = DecodeError::DeviceError;
+        decoded.code = entry.status;
+        return decoded;
     }
+    decoded.error = readValue(entry.bytes, type, decoded.value);
+    return decoded;
+}
 
-    // Extract value and format according to type
-    std::vector<uint8_t> focPayload(info.payload.begin() + 4, 
-                                   info.payload.begin() + 4 + focPayloadLength);
-
-    // If type is provided, format the value accordingly
-    if (type.has_value()) {
-        return "Success: " + formatFocValue(focPayload, type.value());
-    } else {
-        std::stringstream ss;
-        ss << "Success: Raw FOC value = ";
-        for (const auto& byte : focPayload) {
-            ss << byteToHex(byte) << " ";
-        }
-        return ss.str();
+FrameInterpreterRt::Decoded FrameInterpreterRt::decodeBatchEntry(const BatchEntry& entry, ST_MPC::RegisterType type)
+{
+    Decoded decoded;
+    decoded.command = RT::CommandId::FOC_COMMAND_REPLY;
+    if (entry.status != static_cast<uint8_t>(RT::ErrorId::NO_ERROR)) {
+        decoded.error = DecodeError::FocNack;
+        decoded.code = entry.status;
+        return decoded;
     }
+    decoded.error = readValue(entry.bytes, RegisterTable::toRtType(type), decoded.value);
+    return decoded;
 }
 
-std::string FrameInterpreterRt::formatValue(const std::vector<uint8_t>& payload, RT::RegisterType type) const 
+FrameInterpreterRt::DecodeError FrameInterpreterRt::readValue(std::span<const uint8_t> bytes,
+                                                             RT::RegisterType type, Value& value)
 {
-    if (payload.empty()) return "No data";
-    
-    std::stringstream ss;
-
-    // Skip register ID byte for value extraction
-    const uint8_t* valueBytes = payload.data() + 1;
-    size_t valueBytesSize = payload.size() - 1;
-    
     switch (type) {
-        case RT::RegisterType::UInt8: {
-            if (valueBytesSize < 1) return "Error: Invalid payload size for UInt8";
-            uint8_t value = valueBytes[0];
-            ss << "Value: " << static_cast<int>(value);
+        case RT::RegisterType::UInt8:
+            if (bytes.size() < 1) return DecodeError::ShortValue;
+            value = static_cast<uint32_t>(bytes[0]);
             break;
-        }
-        case RT::RegisterType::Int16: {
-            if (valueBytesSize < 2) return "Error: Invalid payload size for Int16";
-            int16_t value = static_cast<int16_t>(valueBytes[0] | (valueBytes[1] << 8));  // Little-endian
-            ss << "Value: " << value;
+        case RT::RegisterType::Int16:
+            if (bytes.size() < 2) return DecodeError::ShortValue;
+            value = static_cast<int32_t>(static_cast<int16_t>(readLe(bytes.data(), 2)));
             break;
-        }
-        case RT::RegisterType::UInt16: {
-            if (valueBytesSize < 2) return "Error: Invalid payload size for UInt16";
-            uint16_t value = static_cast<uint16_t>(valueBytes[0] | (valueBytes[1] << 8));  // Little-endian
-            ss << "Value: " << value;
+        case RT::RegisterType::UInt16:
+            if (bytes.size() < 2) return DecodeError::ShortValue;
+            value = readLe(bytes.data(), 2);
             break;
-        }
-        case RT::RegisterType::Int32: {
-            if (valueBytesSize < 4) return "Error: Invalid payload size for Int32";
-            int32_t value = static_cast<int32_t>(valueBytes[0] | 
-                                              (valueBytes[1] << 8) |
-                                              (valueBytes[2] << 16) |
-                                              (valueBytes[3] << 24));  // Little-endian
-            ss << "Value: " << value;
+        case RT::RegisterType::Int32:
+            if (bytes.size() < 4) return DecodeError::ShortValue;
+            value = static_cast<int32_t>(readLe(bytes.data(), 4));
             break;
-        }
-        case RT::RegisterType::UInt32: {
-            if (valueBytesSize < 4) return "Error: Invalid payload size for UInt32";
-            uint32_t value = static_cast<uint32_t>(valueBytes[0] |
-                                               (valueBytes[1] << 8) |
-                                               (valueBytes[2] << 16) |
-                                               (valueBytes[3] << 24));  // Little-endian
-            ss << "Value: " << value;
+        case RT::RegisterType::UInt32:
+            if (bytes.size() < 4) return DecodeError::ShortValue;
+            value = readLe(bytes.data(), 4);
             break;
-        }
-        case RT::RegisterType::Float: {
-            if (valueBytesSize < 4) return "Error: Invalid payload size for Float";
-            uint32_t bits = (valueBytes[0] |
-                          (valueBytes[1] << 8) |
-                          (valueBytes[2] << 16) |
-                          (valueBytes[3] << 24));  // Little-endian
-            float value = *reinterpret_cast<const float*>(&bits);
-            ss << "Value: " << std::fixed << std::setprecision(6) << value;
-            break;
-        }
-        case RT::RegisterType::CharPtr: {
-            ss << "String: " << std::string(valueBytes, valueBytes + valueBytesSize);
+        case RT::RegisterType::Float:
+            if (bytes.size() < 4) return DecodeError::ShortValue;
+            value = std::bit_cast<float>(readLe(bytes.data(), 4));
             break;
-        }
-        default: {
-            ss << "Raw data: ";
-            for (size_t i = 0; i < valueBytesSize; ++i) {
-                ss << byteToHex(valueBytes[i]) << " ";
-            }
+        case RT::RegisterType::CharPtr:
+        default:
+            value = std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
             break;
-        }
     }
-    
-    return ss.str();
+    return DecodeError::None;
 }
 
-std::string FrameInterpreterRt::formatFocValue(const std::vector<uint8_t>& payload, ST_MPC::RegisterType type) const 
+std::optional<double> FrameInterpreterRt::toNumber(const Value& value)
 {
-    if (payload.empty()) return "No data";
-    
-    std::stringstream ss;
-    
-    switch (type) {
-        case ST_MPC::RegisterType::UInt8: {
-            if (payload.size() < 1) return "Error: Invalid payload size for UInt8";
-            uint8_t value = payload[0];
-            ss << "Value: " << static_cast<int>(value);
-            break;
-        }
-        case ST_MPC::RegisterType::Int16: {
-            if (payload.size() < 2) return "Error: Invalid payload size for Int16";
-            int16_t value = static_cast<int16_t>(payload[0] | (payload[1] << 8));  // Little-endian
-            ss << "Value: " << value;
-            break;
-        }
-        case ST_MPC::RegisterType::UInt16: {
-            if (payload.size() < 2) return "Error: Invalid payload size for UInt16";
-            uint16_t value = static_cast<uint16_t>(payload[0] | (payload[1] << 8));  // Little-endian
-            ss << "Value: " << value;
-            break;
-        }
-        case ST_MPC::RegisterType::Int32: {
-            if (payload.size() < 4) return "Error: Invalid payload size for Int32";
-            int32_t value = static_cast<int32_t>(payload[0] | 
-                                              (payload[1] << 8) |
-                                              (payload[2] << 16) |
-                                              (payload[3] << 24));  // Little-endian
-            ss << "Value: " << value;
-            break;
+    if (auto v = std::get_if<int32_t>(&value)) return *v;
+    if (auto v = std::get_if<uint32_t>(&value)) return *v;
+    if (auto v = std::get_if<float>(&value)) return *v;
+    return std::nullopt;
+}
+
+std::string FrameInterpreterRt::interpretResponse(const std::vector<uint8_t>& response)
+{
+    return format(decode(response));
+}
+
+std::string FrameInterpreterRt::interpretResponse(const std::vector<uint8_t>& response, RT::RegisterType type)
+{
+    return format(decode(response, type));
+}
+
+std::string FrameInterpreterRt::interpretResponse(const std::vector<uint8_t>& response, ST_MPC::RegisterType type)
+{
+    return format(decode(response, type));
+}
+
+std::string FrameInterpreterRt::format(const Decoded& decoded) const
+{
+    if (!decoded.ok()) {
+        return "Error: " + describeError(decoded);
+    }
+
+    if (std::holds_alternative<std::monostate>(decoded.value)) {
+        switch (decoded.command) {
+            case RT::CommandId::RT_WRITE_REPLY:     return "Success: Write command executed";
+            case RT::CommandId::RT_EXECUTE_REPLY:   return "Success: Execute command executed";
+            case RT::CommandId::RT_BATCH_READ_REPLY: return "Success: Batch read reply";
+            default:                                return "Success: FOC command executed";
         }
-        case ST_MPC::RegisterType::UInt32: {
-            if (payload.size() < 4) return "Error: Invalid payload size for UInt32";
-            uint32_t value = static_cast<uint32_t>(payload[0] |
-                                               (payload[1] << 8) |
-                                               (payload[2] << 16) |
-                                               (payload[3] << 24));  // Little-endian
-            ss << "Value: " << value;
-            break;
+    }
+    return "Success: " + formatValue(decoded.value);
+}
+
+std::string FrameInterpreterRt::describeError(const Decoded& decoded) const
+{
+    switch (decoded.error) {
+        case DecodeError::None:
+            return "No error";
+        case DecodeError::InvalidSize:
+            return "Invalid response size";
+        case DecodeError::InvalidCrc:
+            return "Invalid CRC";
+        case DecodeError::DeviceError: {
+            auto it = errorCodes.find(static_cast<RT::ErrorId>(decoded.code));
+            return it != errorCodes.end() ? it->second : "Unknown error: " + byteToHex(decoded.code);
         }
-        case ST_MPC::RegisterType::CharPtr: {
-            ss << "String: " << std::string(payload.begin(), payload.end());
-            break;
+        case DecodeError::UnknownCommand:
+            return "Unknown command type";
+        case DecodeError::EmptyPayload:
+            return "Empty read response";
+        case DecodeError::ShortValue:
+            return "Invalid payload size for register type";
+        case DecodeError::InvalidFocSize:
+            return "Invalid FOC frame size";
+        case DecodeError::InvalidFocCrc:
+            return "Invalid FOC CRC";
+        case DecodeError::InvalidFocAck:
+            return "Invalid FOC ack: " + byteToHex(decoded.code);
+        case DecodeError::BatchMismatch:
+            return "Batch reply does not match request";
+        case DecodeError::FocNack: {
+            auto it = errorCodesFoc.find(static_cast<ST_MPC::AckErrorId>(decoded.code));
+            return it != errorCodesFoc.end() ? it->second : "Unknown FOC error code: " + byteToHex(decoded.code);
         }
-        default: {
-            ss << "Raw data: ";
-            for (const auto& byte : payload) {
-                ss << byteToHex(byte) << " ";
-            }
-            break;
+    }
+    return "Unknown decode error";
+}
+
+std::string FrameInterpreterRt::formatValue(const Value& value) const
+{
+    std::stringstream ss;
+
+    if (auto v = std::get_if<int32_t>(&value)) {
+        ss << "Value: " << *v;
+    } else if (auto v = std::get_if<uint32_t>(&value)) {
+        ss << "Value: " << *v;
+    } else if (auto v = std::get_if<float>(&value)) {
+        ss << "Value: " << std::fixed << std::setprecision(6) << *v;
+    } else if (auto v = std::get_if<std::string_view>(&value)) {
+        ss << "String: " << *v;
+    } else if (auto v = std::get_if<std::span<const uint8_t>>(&value)) {
+        ss << "Raw FOC value = ";
+        for (const auto& byte : *v) {
+            ss << byteToHex(byte) << " ";
         }
+    } else {
+        ss << "No data";
     }
-    
+
     return ss.str();
 }
 
-std::string FrameInterpreterRt::byteToHex(uint8_t byte) 
+std::string FrameInterpreterRt::byteToHex(uint8_t byte)
 {
     std::stringstream ss;
     ss << "0x" << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
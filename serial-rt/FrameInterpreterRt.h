@@ -4,73 +4,87 @@
 #include "RtDefinitions.h"
 #include "StMpcDefinitions.h"
 #include <vector>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <optional>
+#include <variant>
 
-class FrameInterpreterRt 
+class FrameInterpreterRt
 {
 public:
-    // Main interpretation functions
-    std::string interpretResponse(const std::vector<uint8_t>& response);
-    std::string interpretResponse(const std::vector<uint8_t>& response, RT::RegisterType type);
-    std::string interpretResponse(const std::vector<uint8_t>& response, ST_MPC::RegisterType type);
-    void printResponse(const std::vector<uint8_t>& response);
+    enum class DecodeError : uint8_t
+    {
+        None,
+        InvalidSize,        // Shorter than a header
+        InvalidCrc,
+        DeviceError,        // Header errorCode set; code holds the RT::ErrorId
+        UnknownCommand,
+        EmptyPayload,       // Read reply without register id
+        ShortValue,         // Payload too small for the register type
+        InvalidFocSize,
+        InvalidFocCrc,
+        InvalidFocAck,      // code holds the ack byte
+        FocNack,            // code holds the ST_MPC::AckErrorId
+        BatchMismatch       // Batch reply entry count differs from the request
+    };
 
-private:
-    struct Header 
+    // Decoded value; string and raw views point into the response buffer
+    using Value = std::variant<std::monostate,      // Write/execute acknowledge
+                               int32_t,
+                               uint32_t,
+                               float,
+                               std::string_view,    // CharPtr registers
+                               std::span<const uint8_t>>;   // Untyped FOC data
+
+    struct Decoded
     {
-        // Field 0
-        uint8_t startByte;
-        uint8_t totalSize;
-        uint8_t payloadSize;
-        uint8_t mscId;
-        
-        // Field 1
-        uint8_t msgRequestId;
-        uint8_t msgResponseId;
-        uint8_t conversationId;
-        uint8_t senderId;
-        
-        // Field 2
-        uint8_t numBlocks;
-        uint8_t seqId;
-        uint8_t commandType;
-        uint8_t errorCode;
-        
-        // Field 3
-        uint8_t futureUse0;
-        uint8_t futureUse1;
-        uint8_t futureUse2;
-        uint8_t endByte;
+        DecodeError error{DecodeError::None};
+        uint8_t code{0};
+        RT::CommandId command{RT::CommandId::RT_READ_REPLY};
+        Value value;
+
+        bool ok() const { return error == DecodeError::None; }
     };
 
-    struct ResponseInfo 
+    // One register of an RT_BATCH_READ_REPLY; bytes view into the response
+    struct BatchEntry
     {
-        Header header;
-        std::vector<uint8_t> payload;
-        uint8_t crc;
-        bool validCRC;
+        uint8_t status{0};
+        std::span<const uint8_t> bytes;
     };
 
-    // Helper functions for different command types
-    std::string handleRtRead(const ResponseInfo& info, RT::RegisterType type = RT::RegisterType::UInt8);
-    std::string handleRtWrite(const ResponseInfo& info);
-    std::string handleRtExecute(const ResponseInfo& info);
-    std::string handleFocCommand(const ResponseInfo& info, std::optional<ST_MPC::RegisterType> type = std::nullopt);
+    // Allocation-free decoding; the response must outlive the returned value
+    static Decoded decode(std::span<const uint8_t> response);
+    static Decoded decode(std::span<const uint8_t> response, RT::RegisterType type);
+    static Decoded decode(std::span<const uint8_t> response, ST_MPC::RegisterType type);
+    static std::optional<double> toNumber(const Value& value);
 
-    // Parsing helpers
-    ResponseInfo parseResponse(const std::vector<uint8_t>& response);
-    Header parseHeader(const std::vector<uint8_t>& response);
-    bool validateCRC(const std::vector<uint8_t>& frame) const;
-    bool validateWriteReplyCRC(const std::vector<uint8_t>& frame) const;
-    bool validateFocCRC(const std::vector<uint8_t>& focFrame) const;
-    
-    // Value formatting
-    std::string formatValue(const std::vector<uint8_t>& payload, RT::RegisterType type) const;
-    std::string formatFocValue(const std::vector<uint8_t>& payload, ST_MPC::RegisterType type) const;
+    // Split a batch reply into exactly entries.size() entries, then decode each with its type
+    static Decoded decodeBatch(std::span<const uint8_t> response, std::span<BatchEntry> entries);
+    static Decoded decodeBatchEntry(const BatchEntry& entry, RT::RegisterType type);
+    static Decoded decodeBatchEntry(const BatchEntry& entry, ST_MPC::RegisterType type);
+
+    // Text for the CLI
+    std::string format(const Decoded& decoded) const;           // "Success: ..." or "Error: ..."
+    std::string describeError(const Decoded& decoded) const;    // Error text without prefix
+    std::string interpretResponse(const std::vector<uint8_t>& response);
+    std::string interpretResponse(const std::vector<uint8_t>& response, RT::RegisterType type);
+    std::string interpretResponse(const std::vector<uint8_t>& response, ST_MPC::RegisterType type);
+    void printResponse(const std::vector<uint8_t>& response);
+
+private:
+    static bool validateCrc(std::span<const uint8_t> frame);
+    static bool crcExempt(std::span<const uint8_t> response);
+    static Decoded decodeHeader(std::span<const uint8_t> response);
+    static Decoded decodeRtRead(std::span<const uint8_t> response, RT::RegisterType type);
+    static Decoded decodeFoc(std::span<const uint8_t> response, std::optional<ST_MPC::RegisterType> type);
+    static DecodeError readValue(std::span<const uint8_t> bytes, RT::RegisterType type, Value& value);
+
+    std::string formatValue(const Value& value) const;
     static std::string byteToHex(uint8_t byte);
-    
+
     // Error handling
     const std::unordered_map<RT::ErrorId, std::string> errorCodes = {
         {RT::ErrorId::UNKNOWN_START_BYTE, "Unknown Start Byte"},
@@ -92,4 +106,4 @@ private:
     };
 };
 
-#endif // FRAME_INTERPRETER_RT_H
\ No newline at end of file
+#endif // FRAME_INTERPRETER_RT_H
@@ -0,0 +1,212 @@
+#include "LinkStatsRt.h"
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+LinkStatsRt::LinkStatsRt(uint32_t lineRate)
+    : started(std::chrono::steady_clock::now()), lineRate(lineRate)
+{
+    // Intentionally empty
+}
+
+size_t LinkStatsRt::bucketIndex(uint64_t us)
+{
+    us = std::min<uint64_t>(us, (uint64_t{1} << (MAX_MAGNITUDE + 1)) - 1);
+    if (us < (uint64_t{1} << SUB_BITS)) {
+        return static_cast<size_t>(us);
+    }
+    unsigned magnitude = static_cast<unsigned>(std::bit_width(us)) - 1;
+    size_t sub = static_cast<size_t>(us >> (magnitude - SUB_BITS)) & ((size_t{1} << SUB_BITS) - 1);
+    return (static_cast<size_t>(magnitude - SUB_BITS + 1) << SUB_BITS) + sub;
+}
+
+uint64_t LinkStatsRt::bucketUpperBound(size_t index)
+{
+    if (index < (size_t{1} << SUB_BITS)) {
+        return index;
+    }
+    unsigned magnitude = static_cast<unsigned>(index >> SUB_BITS) + SUB_BITS - 1;
+    uint64_t width = uint64_t{1} << (magnitude - SUB_BITS);
+    uint64_t lower = ((uint64_t{1} << SUB_BITS) + (index & ((size_t{1} << SUB_BITS) - 1))) * width;
+    return lower + width - 1;
+}
+
+uint64_t LinkStatsRt::Histogram::percentileUs(double percentile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    auto rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), maxUs);
+        }
+    }
+    return maxUs;
+}
+
+void LinkStatsRt::recordRtt(uint8_t commandId, std::chrono::steady_clock::duration elapsed)
+{
+    size_t type = commandId / 2;
+    if (type >= COMMAND_TYPES) {
+        return;
+    }
+    auto us = static_cast<uint64_t>(std::max<int64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(), 0));
+
+    auto& histogram = rtt[type];
+    add(histogram.count, 1);
+    add(histogram.sumUs, us);
+    add(histogram.buckets[bucketIndex(us)], 1);
+    uint64_t max = histogram.maxUs.load(std::memory_order_relaxed);
+    while (us > max && !histogram.maxUs.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+    }
+}
+
+void LinkStatsRt::setRto(uint8_t commandId, std::chrono::microseconds rto)
+{
+    size_t type = commandId / 2;
+    if (type < COMMAND_TYPES) {
+        rtoUs[type].store(static_cast<uint64_t>(rto.count()), std::memory_order_relaxed);
+    }
+}
+
+LinkStatsRt::Snapshot LinkStatsRt::snapshot() const
+{
+    Snapshot s;
+    s.uptimeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    s.lineRate = lineRate;
+    s.txBytes = txBytes.load(std::memory_order_relaxed);
+    s.txFrames = txFrames.load(std::memory_order_relaxed);
+    s.rxBytes = rxBytes.load(std::memory_order_relaxed);
+    s.rxFrames = rxFrames.load(std::memory_order_relaxed);
+    s.timeouts = timeouts.load(std::memory_order_relaxed);
+    s.crcFailures = crcFailures.load(std::memory_order_relaxed);
+    s.resyncs = resyncs.load(std::memory_order_relaxed);
+    s.staleReplies = staleReplies.load(std::memory_order_relaxed);
+    s.retries = retries.load(std::memory_order_relaxed);
+    for (size_t type = 0; type < COMMAND_TYPES; ++type) {
+        const auto& source = rtt[type];
+        auto& target = s.rtt[type];
+        target.count = source.count.load(std::memory_order_relaxed);
+        target.sumUs = source.sumUs.load(std::memory_order_relaxed);
+        target.maxUs = source.maxUs.load(std::memory_order_relaxed);
+        s.rtoUs[type] = rtoUs[type].load(std::memory_order_relaxed);
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            target.buckets[i] = source.buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+    return s;
+}
+
+const char* LinkStatsRt::commandName(size_t type)
+{
+    switch (type) {
+        case 0: return "execute";
+        case 1: return "write";
+        case 2: return "read";
+        case 3: return "foc";
+        case 4: return "batch-read";
+        default: return "unknown";
+    }
+}
+
+std::string LinkStatsRt::formatSummary(const Snapshot& s)
+{
+    double seconds = std::max(s.uptimeSeconds, 1e-6);
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    ss << "Link: tx " << s.txFrames << " frames, " << s.txBytes << " bytes ("
+       << static_cast<double>(s.txBytes) / seconds << " B/s)"
+       << ", rx " << s.rxFrames << " frames, " << s.rxBytes << " bytes ("
+       << static_cast<double>(s.rxBytes) / seconds << " B/s)";
+    if (s.lineRate > 0) {
+        ss << "\nLink load: tx " << 100.0 * static_cast<double>(s.txBytes) / seconds / s.lineRate
+           << "%, rx " << 100.0 * static_cast<double>(s.rxBytes) / seconds / s.lineRate
+           << "% of " << s.lineRate << " B/s";
+    }
+    ss << "\nLink errors: " << s.timeouts << " timeouts, " << s.crcFailures << " CRC failures, "
+       << s.resyncs << " resyncs, " << s.staleReplies << " stale replies, " << s.retries << " retries";
+    for (size_t type = 0; type < COMMAND_TYPES; ++type) {
+        const auto& h = s.rtt[type];
+        if (h.count == 0) {
+            continue;
+        }
+        ss << "\nRTT " << commandName(type) << ": " << h.count << " requests, mean " << h.meanUs()
+           << " us, p50 " << h.percentileUs(50) << " us, p99 " << h.percentileUs(99)
+           << " us, max " << h.maxUs << " us, timeout " << s.rtoUs[type] << " us";
+    }
+    return ss.str();
+}
+
+std::string LinkStatsRt::formatJson(const Snapshot& s)
+{
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "{\"time_ms\":" << now << ",\"uptime_s\":" << s.uptimeSeconds << ",\"line_rate\":" << s.lineRate
+       << ",\"tx_bytes\":" << s.txBytes << ",\"tx_frames\":" << s.txFrames
+       << ",\"rx_bytes\":" << s.rxBytes << ",\"rx_frames\":" << s.rxFrames
+       << ",\"timeouts\":" << s.timeouts << ",\"crc_failures\":" << s.crcFailures
+       << ",\"resyncs\":" << s.resyncs << ",\"stale_replies\":" << s.staleReplies
+       << ",\"retries\":" << s.retries << ",\"rtt_us\":{";
+    bool first = true;
+    for (size_t type = 0; type < COMMAND_TYPES; ++type) {
+        const auto& h = s.rtt[type];
+        if (h.count == 0) {
+            continue;
+        }
+        ss << (first ? "" : ",") << "\"" << commandName(type) << "\":{\"count\":" << h.count
+           << ",\"mean\":" << h.meanUs() << ",\"p50\":" << h.percentileUs(50) << ",\"p90\":" << h.percentileUs(90)
+           << ",\"p99\":" << h.percentileUs(99) << ",\"max\":" << h.maxUs << ",\"rto\":" << s.rtoUs[type] << "}";
+        first = false;
+    }
+    ss << "}}";
+    return ss.str();
+}
+
+LinkStatsDumpRt::~LinkStatsDumpRt()
+{
+    stop();
+}
+
+void LinkStatsDumpRt::start(const LinkStatsRt& stats, const std::string& filename, std::chrono::milliseconds interval)
+{
+    stop();
+    file.open(filename, std::ios::app);
+    if (!file) {
+        throw std::runtime_error("Cannot open " + filename);
+    }
+    stopping = false;
+    worker = std::thread(&LinkStatsDumpRt::run, this, std::cref(stats), interval);
+}
+
+void LinkStatsDumpRt::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+void LinkStatsDumpRt::run(const LinkStatsRt& stats, std::chrono::milliseconds interval)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        wake.wait_for(lock, interval, [this] { return stopping; });
+        // A final line on stop, so the file always ends with the totals
+        file << LinkStatsRt::formatJson(stats.snapshot()) << '\n' << std::flush;
+    }
+}
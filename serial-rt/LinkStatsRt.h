@@ -0,0 +1,137 @@
+// LinkStatsRt.h
+#ifndef LINK_STATS_RT_H
+#define LINK_STATS_RT_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Link-level counters maintained by SerialConnectionRt. Every update is a relaxed atomic
+// add on a preallocated counter, with no lock and no allocation, so they are always on. A snapshot
+// reads each counter separately and may be a few events apart between counters.
+class LinkStatsRt
+{
+public:
+    // Request command types, RT::CommandId / 2 (replies are request + 1)
+    static constexpr size_t COMMAND_TYPES = 5;
+
+    // Round-trip times in microseconds, HDR-style: values below 2^SUB_BITS are exact, above
+    // that every power of two is split into 2^SUB_BITS buckets (within 12.5%), up to 2^MAX_MAGNITUDE us
+    static constexpr unsigned SUB_BITS = 3;
+    static constexpr unsigned MAX_MAGNITUDE = 26;      // About 67 s
+    static constexpr size_t BUCKETS = (MAX_MAGNITUDE - SUB_BITS + 2) << SUB_BITS;
+
+    struct Histogram
+    {
+        uint64_t count{0};
+        uint64_t sumUs{0};
+        uint64_t maxUs{0};
+        std::array<uint64_t, BUCKETS> buckets{};
+
+        double meanUs() const { return count ? static_cast<double>(sumUs) / static_cast<double>(count) : 0.0; }
+        uint64_t percentileUs(double percentile) const;     // Upper bound of the bucket, 0 when empty
+    };
+
+    struct Snapshot
+    {
+        double uptimeSeconds{0.0};
+        uint32_t lineRate{0};       // Bytes/s the port carries, 0 if unknown
+        uint64_t txBytes{0};
+        uint64_t txFrames{0};
+        uint64_t rxBytes{0};
+        uint64_t rxFrames{0};
+        uint64_t timeouts{0};
+        uint64_t crcFailures{0};
+        uint64_t resyncs{0};        // False start bytes dropped while hunting for a frame
+        uint64_t staleReplies{0};   // Replies that matched no outstanding request
+        uint64_t retries{0};        // Requests sent again after a timeout
+        std::array<Histogram, COMMAND_TYPES> rtt{};
+        std::array<uint64_t, COMMAND_TYPES> rtoUs{};     // Current reply timeout, 0 until measured
+    };
+
+    explicit LinkStatsRt(uint32_t lineRate = 0);
+
+    void addTx(size_t bytes) { add(txBytes, bytes); add(txFrames, 1); }
+    void addRxBytes(size_t bytes) { add(rxBytes, bytes); }
+    void addRxFrame() { add(rxFrames, 1); }
+    void addTimeout() { add(timeouts, 1); }
+    void addCrcFailure() { add(crcFailures, 1); }
+    void addResync() { add(resyncs, 1); }
+    void addStaleReply() { add(staleReplies, 1); }
+    void addRetry() { add(retries, 1); }
+    void recordRtt(uint8_t commandId, std::chrono::steady_clock::duration rtt);
+    void setRto(uint8_t commandId, std::chrono::microseconds rto);
+
+    Snapshot snapshot() const;
+
+    static const char* commandName(size_t type);
+    static size_t bucketIndex(uint64_t us);
+    static uint64_t bucketUpperBound(size_t index);
+
+    // Human-readable block for log-status, and one JSON object per line for machines
+    static std::string formatSummary(const Snapshot& snapshot);
+    static std::string formatJson(const Snapshot& snapshot);
+
+private:
+    struct AtomicHistogram
+    {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sumUs{0};
+        std::atomic<uint64_t> maxUs{0};
+        std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+    static void add(std::atomic<uint64_t>& counter, uint64_t amount)
+    {
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    std::chrono::steady_clock::time_point started;
+    uint32_t lineRate;
+    std::atomic<uint64_t> txBytes{0};
+    std::atomic<uint64_t> txFrames{0};
+    std::atomic<uint64_t> rxBytes{0};
+    std::atomic<uint64_t> rxFrames{0};
+    std::atomic<uint64_t> timeouts{0};
+    std::atomic<uint64_t> crcFailures{0};
+    std::atomic<uint64_t> resyncs{0};
+    std::atomic<uint64_t> staleReplies{0};
+    std::atomic<uint64_t> retries{0};
+    std::array<AtomicHistogram, COMMAND_TYPES> rtt;
+    std::array<std::atomic<uint64_t>, COMMAND_TYPES> rtoUs{};
+};
+
+// Appends LinkStatsRt::formatJson lines to a file at a fixed interval from its own thread
+class LinkStatsDumpRt
+{
+public:
+    LinkStatsDumpRt() = default;
+    ~LinkStatsDumpRt();
+    LinkStatsDumpRt(const LinkStatsDumpRt&) = delete;
+    LinkStatsDumpRt& operator=(const LinkStatsDumpRt&) = delete;
+
+    // Restarts the dump if one is running; throws std::runtime_error if the file cannot be opened
+    void start(const LinkStatsRt& stats, const std::string& filename, std::chrono::milliseconds interval);
+    void stop();
+    bool isRunning() const { return worker.joinable(); }
+
+private:
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping{false};
+    std::ofstream file;
+
+    void run(const LinkStatsRt& stats, std::chrono::milliseconds interval);
+};
+
+#endif // LINK_STATS_RT_H
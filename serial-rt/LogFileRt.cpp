@@ -0,0 +1,502 @@
+// LogFileRt.cpp
+#include "LogFileRt.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+    template <typename T>
+    void put(uint8_t*& out, T value)
+    {
+        std::memcpy(out, &value, sizeof(T));
+        out += sizeof(T);
+    }
+
+    constexpr char MAGIC[6] = {'R', 'T', 'L', 'O', 'G', '\0'};
+    constexpr size_t RECORD_HEADER_SIZE = sizeof(uint8_t) + sizeof(uint32_t);
+
+    int64_t toMicros(std::chrono::system_clock::time_point timestamp)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            timestamp.time_since_epoch()).count();
+    }
+}
+
+bool isSignedColumn(LogColumnType type)
+{
+    return type == LogColumnType::Int16 || type == LogColumnType::Int32;
+}
+
+std::string_view textOf(const LogRow& row, size_t column)
+{
+    const auto& ref = row.values[column].text;
+    return row.text.substr(ref.offset, ref.length);
+}
+
+double numericValue(const LogValue& value, LogColumnType type)
+{
+    if (type == LogColumnType::Float32) {
+        return value.f32;
+    }
+    if (isSignedColumn(type)) {
+        return value.i32;
+    }
+    if (type == LogColumnType::String) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return value.u32;
+}
+
+// CSV writer
+
+CsvLogWriterRt::CsvLogWriterRt(size_t bufferSize, bool useTimestamp)
+    : bufferSize(bufferSize), useTimestamp(useTimestamp)
+{
+    buffer.reserve(bufferSize + 256);
+}
+
+CsvLogWriterRt::~CsvLogWriterRt()
+{
+    close();
+}
+
+void CsvLogWriterRt::open(const std::string& filename)
+{
+    file.open(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file.is_open()) {
+        throw LogFileError("Unable to open log file: " + filename);
+    }
+    buffer.clear();
+    flushed = 0;
+}
+
+void CsvLogWriterRt::close()
+{
+    if (file.is_open()) {
+        flushBuffer();
+        file.close();
+    }
+}
+
+void CsvLogWriterRt::writeSchema(std::span<const LogColumn> newColumns)
+{
+    // A register change appends a new header line rather than overwriting earlier rows
+    columns.assign(newColumns.begin(), newColumns.end());
+    if (useTimestamp) {
+        buffer += "Timestamp";
+    }
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (useTimestamp || i > 0) {
+            buffer += ',';
+        }
+        buffer += columns[i].name;
+    }
+    buffer += '\n';
+    flushBuffer();
+}
+
+void CsvLogWriterRt::writeRow(const LogRow& row)
+{
+    char digits[32];
+    if (useTimestamp) {
+        auto result = std::to_chars(digits, digits + sizeof(digits), toMicros(row.timestamp));
+        buffer.append(digits, result.ptr);
+    }
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (useTimestamp || i > 0) {
+            buffer += ',';
+        }
+        if (row.present[i]) {
+            appendValue(row, i);
+        }
+    }
+    buffer += '\n';
+
+    if (buffer.size() >= bufferSize) {
+        flushBuffer();
+    }
+}
+
+void CsvLogWriterRt::appendValue(const LogRow& row, size_t column)
+{
+    char digits[32];
+    std::to_chars_result result;
+    const LogValue& value = row.values[column];
+    LogColumnType type = columns[column].type;
+
+    if (type == LogColumnType::String) {
+        // Quoted, so commas in register text do not shift columns
+        buffer += '"';
+        for (char c : textOf(row, column)) {
+            if (c == '"') {
+                buffer += '"';
+            }
+            buffer += c;
+        }
+        buffer += '"';
+        return;
+    }
+    if (type == LogColumnType::Float32) {
+        // Shortest representation that reads back to the same float
+        result = std::to_chars(digits, digits + sizeof(digits), value.f32);
+    } else if (isSignedColumn(type)) {
+        result = std::to_chars(digits, digits + sizeof(digits), value.i32);
+    } else {
+        result = std::to_chars(digits, digits + sizeof(digits), value.u32);
+    }
+    buffer.append(digits, result.ptr);
+}
+
+void CsvLogWriterRt::flushBuffer()
+{
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.flush();
+    flushed += buffer.size();
+    buffer.clear();
+}
+
+// Binary writer
+
+BinaryLogWriterRt::~BinaryLogWriterRt()
+{
+    try {
+        close();
+    }
+    catch (const LogFileError&) {
+        // Nothing left to report to
+    }
+}
+
+void BinaryLogWriterRt::open(const std::string& name)
+{
+    close();
+    fd = ::open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw LogFileError("Unable to open log file: " + name + ": " + std::strerror(errno));
+    }
+    filename = name;
+    offset = 0;
+    columnTypes.clear();
+
+    uint8_t* out = reserve(sizeof(MAGIC) + sizeof(uint16_t));
+    std::memcpy(out, MAGIC, sizeof(MAGIC));
+    out += sizeof(MAGIC);
+    put(out, VERSION);
+}
+
+void BinaryLogWriterRt::close()
+{
+    if (fd < 0) {
+        return;
+    }
+    unmap();
+    // Drop the unused tail of the last chunk
+    if (ftruncate(fd, static_cast<off_t>(offset)) != 0) {
+        ::close(fd);
+        fd = -1;
+        throw LogFileError("Unable to truncate log file: " + filename + ": " + std::strerror(errno));
+    }
+    ::close(fd);
+    fd = -1;
+}
+
+void BinaryLogWriterRt::writeSchema(std::span<const LogColumn> columns)
+{
+    uint32_t length = sizeof(uint16_t);
+    for (const auto& column : columns) {
+        length += 3 * sizeof(uint8_t) + std::min<size_t>(column.name.size(), 255);
+    }
+
+    uint8_t* out = reserve(RECORD_HEADER_SIZE + length);
+    put<uint8_t>(out, 'S');
+    put(out, length);
+    put(out, static_cast<uint16_t>(columns.size()));
+    for (const auto& column : columns) {
+        auto nameLength = static_cast<uint8_t>(std::min<size_t>(column.name.size(), 255));
+        put(out, static_cast<uint8_t>(column.type));
+        put(out, static_cast<uint8_t>(column.rateClass | (column.onChange ? RATE_ON_CHANGE : 0)));
+        put(out, nameLength);
+        std::memcpy(out, column.name.data(), nameLength);
+        out += nameLength;
+    }
+
+    columnTypes.clear();
+    for (const auto& column : columns) {
+        columnTypes.push_back(column.type);
+    }
+}
+
+void BinaryLogWriterRt::writeRow(const LogRow& row)
+{
+    size_t count = columnTypes.size();
+    size_t bitmapSize = (count + 7) / 8;
+    uint32_t length = static_cast<uint32_t>(sizeof(int64_t) + bitmapSize);
+    for (size_t i = 0; i < count; ++i) {
+        if (row.present[i]) {
+            length += static_cast<uint32_t>(typeWidth(columnTypes[i]));
+            if (columnTypes[i] == LogColumnType::String) {
+                length += static_cast<uint32_t>(std::min<size_t>(row.values[i].text.length, 255));
+            }
+        }
+    }
+
+    uint8_t* out = reserve(RECORD_HEADER_SIZE + length);
+    put<uint8_t>(out, 'D');
+    put(out, length);
+    put(out, toMicros(row.timestamp));
+
+    uint8_t* bitmap = out;
+    std::memset(bitmap, 0, bitmapSize);
+    out += bitmapSize;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (!row.present[i]) {
+            continue;
+        }
+        bitmap[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+        const LogValue& value = row.values[i];
+        switch (columnTypes[i]) {
+            case LogColumnType::UInt8:   put(out, static_cast<uint8_t>(value.u32)); break;
+            case LogColumnType::Int16:   put(out, static_cast<int16_t>(value.i32)); break;
+            case LogColumnType::UInt16:  put(out, static_cast<uint16_t>(value.u32)); break;
+            case LogColumnType::Int32:   put(out, value.i32); break;
+            case LogColumnType::UInt32:  put(out, value.u32); break;
+            case LogColumnType::Float32: put(out, value.f32); break;
+            case LogColumnType::String: {
+                auto text = textOf(row, i).substr(0, 255);
+                put(out, static_cast<uint8_t>(text.size()));
+                std::memcpy(out, text.data(), text.size());
+                out += text.size();
+                break;
+            }
+        }
+    }
+}
+
+size_t BinaryLogWriterRt::typeWidth(LogColumnType type)
+{
+    switch (type) {
+        case LogColumnType::UInt8:
+        case LogColumnType::String: return 1;
+        case LogColumnType::Int16:
+        case LogColumnType::UInt16: return 2;
+        default:                    return 4;
+    }
+}
+
+uint8_t* BinaryLogWriterRt::reserve(size_t size)
+{
+    if (offset + size > mappedSize) {
+        // Grow by whole chunks so remapping stays rare
+        size_t newSize = mappedSize + CHUNK_SIZE;
+        while (offset + size > newSize) {
+            newSize += CHUNK_SIZE;
+        }
+        unmap();
+        int error = posix_fallocate(fd, 0, static_cast<off_t>(newSize));
+        if (error != 0) {
+            throw LogFileError("Unable to extend log file: " + filename + ": " + std::strerror(error));
+        }
+        void* address = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            throw LogFileError("Unable to map log file: " + filename + ": " + std::strerror(errno));
+        }
+        map = static_cast<uint8_t*>(address);
+        mappedSize = newSize;
+    }
+
+    uint8_t* out = map + offset;
+    offset += size;
+    return out;
+}
+
+void BinaryLogWriterRt::unmap()
+{
+    if (map != nullptr) {
+        munmap(map, mappedSize);
+        map = nullptr;
+        mappedSize = 0;
+    }
+}
+
+// Rotating writer
+
+RotatingLogWriterRt::RotatingLogWriterRt(WriterFactory factory, const Limits& limits)
+    : factory(std::move(factory)), limits(limits)
+{
+    // Intentionally empty
+}
+
+RotatingLogWriterRt::~RotatingLogWriterRt()
+{
+    try {
+        close();
+    }
+    catch (const LogFileError&) {
+        // Nothing left to report to
+    }
+}
+
+void RotatingLogWriterRt::open(const std::string& filename)
+{
+    close();
+    size_t slash = filename.find_last_of('/');
+    size_t dot = filename.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        dot = filename.size();
+    }
+    stem = filename.substr(0, dot);
+    extension = filename.substr(dot);
+
+    removePreviousRun();
+    segments.clear();
+    closedBytes = 0;
+    columns.clear();
+    openSegment(1);
+}
+
+void RotatingLogWriterRt::close()
+{
+    if (!current) {
+        return;
+    }
+    closeSegment();
+    writeIndex();
+}
+
+void RotatingLogWriterRt::writeSchema(std::span<const LogColumn> newColumns)
+{
+    columns.assign(newColumns.begin(), newColumns.end());
+    current->writeSchema(columns);
+}
+
+void RotatingLogWriterRt::writeRow(const LogRow& row)
+{
+    int64_t timestamp = toMicros(row.timestamp);
+    Segment& segment = segments.back();
+    bool full = limits.maxBytes > 0 && current->bytesWritten() >= limits.maxBytes;
+    bool expired = limits.maxAge.count() > 0 && segment.rows > 0 &&
+               timestamp - segment.firstUs >= std::chrono::duration_cast<std::chrono::microseconds>(limits.maxAge).count();
+    if (full || expired) {
+        uint32_t next = segment.number + 1;
+        closeSegment();
+        enforceBudget();
+        openSegment(next);
+        current->writeSchema(columns);
+    }
+
+    Segment& active = segments.back();
+    if (active.rows == 0) {
+        active.firstUs = timestamp;
+    }
+    active.lastUs = timestamp;
+    active.rows++;
+    current->writeRow(row);
+}
+
+uint64_t RotatingLogWriterRt::bytesWritten() const
+{
+    return closedBytes + (current ? current->bytesWritten() : 0);
+}
+
+std::string RotatingLogWriterRt::segmentName(uint32_t number) const
+{
+    char digits[16];
+    std::snprintf(digits, sizeof(digits), ".%06u", number);
+    return stem + digits + extension;
+}
+
+std::string RotatingLogWriterRt::indexName() const
+{
+    return stem + ".index";
+}
+
+void RotatingLogWriterRt::openSegment(uint32_t number)
+{
+    Segment segment{number, segmentName(number)};
+    current = factory();
+    current->open(segment.filename);
+
+    // Reserve the blocks the segment will need; best effort, not every file system supports it
+    if (limits.maxBytes > 0) {
+        int fd = ::open(segment.filename.c_str(), O_WRONLY);
+        if (fd >= 0) {
+            fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(limits.maxBytes));
+            ::close(fd);
+        }
+    }
+    segments.push_back(segment);
+    writeIndex();
+}
+
+void RotatingLogWriterRt::closeSegment()
+{
+    Segment& segment = segments.back();
+    current->close();
+    segment.bytes = current->bytesWritten();
+    current.reset();
+    closedBytes += segment.bytes;
+
+    // Give back the reserved blocks past the end
+    if (truncate(segment.filename.c_str(), static_cast<off_t>(segment.bytes)) != 0) {
+        throw LogFileError("Unable to truncate log segment: " + segment.filename + ": " + std::strerror(errno));
+    }
+}
+
+void RotatingLogWriterRt::enforceBudget()
+{
+    if (limits.diskBudget == 0) {
+        return;
+    }
+    // The next segment may grow to maxBytes, so keep room for it
+    while (segments.size() > 0 && closedBytes + limits.maxBytes > limits.diskBudget) {
+        const Segment& oldest = segments.front();
+        if (unlink(oldest.filename.c_str()) != 0 && errno != ENOENT) {
+            throw LogFileError("Unable to delete log segment: " + oldest.filename + ": " + std::strerror(errno));
+        }
+        closedBytes -= oldest.bytes;
+        segments.pop_front();
+    }
+}
+
+void RotatingLogWriterRt::writeIndex() const
+{
+    // Written beside and renamed over the index, so a reader never sees half of it
+    std::string name = indexName();
+    std::string temporary = name + ".tmp";
+    {
+        std::ofstream index(temporary, std::ios::out | std::ios::trunc);
+        if (!index) {
+            throw LogFileError("Unable to write log index: " + temporary);
+        }
+        index << "segment,file,first_us,last_us,rows,bytes\n";
+        for (const auto& segment : segments) {
+            uint64_t bytes = &segment == &segments.back() && current ? current->bytesWritten() : segment.bytes;
+            index << segment.number << ',' << segment.filename << ',' << segment.firstUs << ','
+                  << segment.lastUs << ',' << segment.rows << ',' << bytes << '\n';
+        }
+    }
+    if (std::rename(temporary.c_str(), name.c_str()) != 0) {
+        throw LogFileError("Unable to replace log index: " + name + ": " + std::strerror(errno));
+    }
+}
+
+void RotatingLogWriterRt::removePreviousRun() const
+{
+    std::ifstream index(indexName());
+    std::string line;
+    std::getline(index, line);     // Header
+    while (std::getline(index, line)) {
+        size_t first = line.find(',');
+        size_t second = line.find(',', first + 1);
+        if (first != std::string::npos && second != std::string::npos) {
+            unlink(line.substr(first + 1, second - first - 1).c_str());
+        }
+    }
+}
@@ -0,0 +1,208 @@
+// LogFileRt.h
+#ifndef LOG_FILE_RT_H
+#define LOG_FILE_RT_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Native register types as stored in the logs; values are little-endian
+enum class LogColumnType : uint8_t
+{
+    UInt8 = 1,
+    Int16 = 2,
+    UInt16 = 3,
+    Int32 = 4,
+    UInt32 = 5,
+    Float32 = 6,    // IEEE-754 single, bit-exact register value
+    String = 7
+};
+
+struct LogColumn
+{
+    std::string name;
+    LogColumnType type;
+    uint8_t rateClass;      // LoggerRt::RateClass, informational
+    bool onChange{false};   // Present only in rows where it changed or its keep-alive fell due
+};
+
+// One column value, interpreted through the column type: signed types use i32,
+// unsigned types u32, Float32 f32 and String a slice of LogRow::text
+union LogValue
+{
+    struct TextRef
+    {
+        uint16_t offset;
+        uint16_t length;
+    };
+
+    int32_t i32;
+    uint32_t u32;
+    float f32;
+    TextRef text;
+};
+
+// One sample: values[i] is valid when present[i] is set
+struct LogRow
+{
+    std::chrono::system_clock::time_point timestamp;
+    std::span<const LogValue> values;
+    std::span<const uint8_t> present;
+    std::string_view text;  // Storage of the String values
+};
+
+bool isSignedColumn(LogColumnType type);
+std::string_view textOf(const LogRow& row, size_t column);
+double numericValue(const LogValue& value, LogColumnType type);    // NaN for String
+
+class LogWriterRt
+{
+public:
+    class LogFileError : public std::runtime_error
+    {
+    public:
+        explicit LogFileError(const std::string& message) : std::runtime_error(message) {}
+    };
+
+    virtual ~LogWriterRt() = default;
+
+    virtual void open(const std::string& filename) = 0;
+    virtual void close() = 0;
+    // Starts a new column set; rows written afterwards follow it
+    virtual void writeSchema(std::span<const LogColumn> columns) = 0;
+    virtual void writeRow(const LogRow& row) = 0;
+    virtual uint64_t bytesWritten() const = 0;     // Size of the file once closed
+};
+
+// Text log read live by plot.py; rows are formatted into a buffer and written once it fills
+class CsvLogWriterRt : public LogWriterRt
+{
+public:
+    CsvLogWriterRt(size_t bufferSize, bool useTimestamp);
+    ~CsvLogWriterRt() override;
+
+    void open(const std::string& filename) override;
+    void close() override;
+    void writeSchema(std::span<const LogColumn> columns) override;
+    void writeRow(const LogRow& row) override;
+    uint64_t bytesWritten() const override { return flushed + buffer.size(); }
+
+private:
+    std::ofstream file;
+    uint64_t flushed{0};
+    std::string buffer;
+    size_t bufferSize;
+    bool useTimestamp;
+    std::vector<LogColumn> columns;
+
+    void appendValue(const LogRow& row, size_t column);
+    void flushBuffer();
+};
+
+// Binary columnar log written through a memory-mapped file that grows in preallocated chunks.
+//
+// Layout (little-endian):
+//   file header  "RTLOG\0" magic, uint16 version
+//   records      uint8 kind, uint32 payload length, payload
+//     'S' schema   uint16 count, then per column: uint8 type, uint8 rate, uint8 name length, name;
+//                  bit 7 of rate marks an on-change column
+//     'D' sample   int64 timestamp [us since epoch], presence bitmap of (count + 7) / 8 bytes,
+//                  then the value of each present column at its type width; String values are
+//                  uint8 length followed by the bytes
+// A schema record is emitted at start and on every register change; readers skip unknown kinds.
+class BinaryLogWriterRt : public LogWriterRt
+{
+public:
+    static constexpr uint16_t VERSION = 2;     // 1 stored floats as int32 * 1000
+    static constexpr size_t CHUNK_SIZE = 4 * 1024 * 1024;
+    static constexpr uint8_t RATE_ON_CHANGE = 0x80;
+
+    BinaryLogWriterRt() = default;
+    ~BinaryLogWriterRt() override;
+
+    void open(const std::string& filename) override;
+    void close() override;
+    void writeSchema(std::span<const LogColumn> columns) override;
+    void writeRow(const LogRow& row) override;
+    uint64_t bytesWritten() const override { return offset; }
+
+    static size_t typeWidth(LogColumnType type);    // String: length byte only
+
+private:
+    int fd{-1};
+    uint8_t* map{nullptr};
+    size_t mappedSize{0};
+    size_t offset{0};
+    std::string filename;
+    std::vector<LogColumnType> columnTypes;
+
+    uint8_t* reserve(size_t size);
+    void unmap();
+};
+
+// Splits a long log into numbered segments <stem>.NNNNNN<ext> (rt_log.csv -> rt_log.000001.csv),
+// each written by its own inner writer and so starting with its own header and schema. A segment
+// is closed once it holds maxBytes or spans maxAge; its disk blocks are reserved when it is opened
+// (fallocate without changing the file size) and released past the end when it is closed.
+// <stem>.index lists the segments on disk, one CSV line each with the time span, rows and bytes.
+// When the segments exceed diskBudget, the oldest are deleted. Nothing is fsynced.
+class RotatingLogWriterRt : public LogWriterRt
+{
+public:
+    struct Limits
+    {
+        uint64_t maxBytes{0};               // 0 = no size limit
+        std::chrono::seconds maxAge{0};     // 0 = no time limit
+        uint64_t diskBudget{0};             // Total of all segments, 0 = unlimited
+    };
+
+    using WriterFactory = std::function<std::unique_ptr<LogWriterRt>()>;
+
+    RotatingLogWriterRt(WriterFactory factory, const Limits& limits);
+    ~RotatingLogWriterRt() override;
+
+    // Deletes the segments of the previous run listed in the index, then starts segment 1
+    void open(const std::string& filename) override;
+    void close() override;
+    void writeSchema(std::span<const LogColumn> columns) override;
+    void writeRow(const LogRow& row) override;
+    uint64_t bytesWritten() const override;     // All segments on disk
+
+private:
+    struct Segment
+    {
+        uint32_t number;
+        std::string filename;
+        int64_t firstUs{0};
+        int64_t lastUs{0};
+        uint64_t rows{0};
+        uint64_t bytes{0};
+    };
+
+    WriterFactory factory;
+    Limits limits;
+    std::unique_ptr<LogWriterRt> current;
+    std::deque<Segment> segments;       // Oldest first; the last one is open
+    uint64_t closedBytes{0};
+    std::vector<LogColumn> columns;
+    std::string stem;
+    std::string extension;
+
+    std::string segmentName(uint32_t number) const;
+    std::string indexName() const;
+    void openSegment(uint32_t number);
+    void closeSegment();
+    void enforceBudget();
+    void writeIndex() const;
+    void removePreviousRun() const;
+};
+
+#endif // LOG_FILE_RT_H
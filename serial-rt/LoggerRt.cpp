@@ -1,11 +1,11 @@
 // LoggerRt.cpp
 #include "LoggerRt.h"
 #include "FrameBuilderRt.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
 #include <iostream>
-#include <iomanip>
-#include <sstream>
-
-std::mutex LoggerRt::readMutex;  // Define static mutex
 
 LoggerRt::LoggerRt(SerialConnectionRt& serial, uint8_t mscId, const LogConfig& config)
     : serial(serial), mscId(mscId), config(config) 
@@ -16,25 +16,66 @@ LoggerRt::LoggerRt(SerialConnectionRt& serial, uint8_t mscId, const LogConfig& c
 LoggerRt::~LoggerRt() 
 {
     stop();
-    if (loggerThread.joinable()) {
-        loggerThread.join();
-    }
 }
 
 // Basic operations remain the same
 void LoggerRt::start() 
 {
     if (!running.exchange(true)) {
-        if (!fileOpened) {
-            logFile.open(config.filename, std::ios::out | std::ios::trunc);
-            if (!logFile.is_open()) {
-                running.store(false);
-                throw std::runtime_error("Unable to open log file: " + config.filename);
+        auto makeWriter = [this]() -> std::unique_ptr<LogWriterRt> {
+            if (config.format == LogFormat::Binary) {
+                return std::make_unique<BinaryLogWriterRt>();
             }
-            fileOpened = true;
+            return std::make_unique<CsvLogWriterRt>(config.bufferSize, config.useTimestamp);
+        };
+        if (config.segmentBytes > 0 || config.segmentDuration.count() > 0) {
+            writer = std::make_unique<RotatingLogWriterRt>(makeWriter,
+                RotatingLogWriterRt::Limits{config.segmentBytes, config.segmentDuration, config.diskBudget});
+        } else {
+            writer = makeWriter();
+        }
+        try {
+            writer->open(config.filename);
+        }
+        catch (const std::exception&) {
+            writer.reset();
+            running.store(false);
+            throw;
         }
 
-        writeHeader();
+        {
+            std::lock_guard<std::mutex> lock(timingMutex);
+            timing = TimingStats{};
+            periodM2 = 0.0;
+        }
+        if (!config.telemetryName.empty()) {
+            try {
+                telemetry.open(config.telemetryName);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Live telemetry disabled: " << e.what() << std::endl;
+            }
+        }
+        queue = std::make_unique<SpscRing<SampleRecord>>(config.queueCapacity);
+        pendingSchemas.clear();
+        writerSchemas.clear();
+        receivedVersion = 0;
+        writtenVersion = 0;
+        captureRing.assign(config.capture.enabled ? config.capture.preSamples : 0, SampleRecord{});
+        ringNext = 0;
+        ringCount = 0;
+        postRemaining = 0;
+        manualTrigger = false;
+        captures = 0;
+        recording = false;
+        lastTrigger.clear();
+        queueMaxFill = 0;
+        samplesWritten = 0;
+        queueOverflows = 0;
+        writeErrors = 0;
+
+        writerRunning.store(true);
+        writerThread = std::thread(&LoggerRt::writeSamples, this);
         loggerThread = std::thread(&LoggerRt::loggingThread, this);
     }
 }
@@ -45,10 +86,16 @@ void LoggerRt::stop()
         if (loggerThread.joinable()) {
             loggerThread.join();
         }
-        if (logFile.is_open()) {
-            logFile.close();
-            fileOpened = false;
+        // The writer drains what the logging thread queued before exiting
+        writerRunning.store(false);
+        if (writerThread.joinable()) {
+            writerThread.join();
         }
+        if (writer) {
+            writer->close();
+            writer.reset();
+        }
+        telemetry.close();
     }
 }
 
@@ -58,61 +105,79 @@ bool LoggerRt::isRunning() const
 }
 
 // New register handling methods
-bool LoggerRt::addRtRegister(const std::string& regName, RT::RegisterId regId, RT::RegisterType type) 
+std::string LoggerRt::logName(std::string_view regName, uint8_t regMscId) const
+{
+    std::string name(regName);
+    if (regMscId != mscId) {
+        name += "@" + std::to_string(regMscId);
+    }
+    return name;
+}
+
+bool LoggerRt::addRtRegister(const RegisterTable::RtRegister& reg, uint8_t regMscId, std::optional<RateClass> rate,
+                             bool onChange) 
 {
     std::lock_guard<std::mutex> lock(registersMutex);
     
+    std::string name = logName(reg.name, regMscId);
     auto it = std::find_if(registers.begin(), registers.end(),
-        [&regName](const RtRegisterInfo& info) { return info.name == regName; });
+        [&name](const RtRegisterInfo& info) { return info.name == name; });
     
     if (it != registers.end()) {
         return false;
     }
+    if (registers.size() >= MAX_REGISTERS) {
+        throw std::runtime_error("Cannot log more than " + std::to_string(MAX_REGISTERS) + " registers");
+    }
 
-    RtRegisterInfo info{regId, type, regName, false};  // false = RT register
+    RtRegisterInfo info{reg.id, reg.type, name, false, rate.value_or(defaultRateClass(reg.id))};  // false = RT register
+    info.mscId = regMscId;
+    info.onChange = onChange;
     registers.push_back(info);
-    
-    if (running.load()) {
-        writeHeader();
-    }
-    
+    ++registersVersion;
     return true;
 }
 
-bool LoggerRt::addFocRegister(const std::string& regName, ST_MPC::RegisterId regId, ST_MPC::RegisterType type) 
+bool LoggerRt::addFocRegister(const RegisterTable::FocRegister& reg, uint8_t regMscId, std::optional<RateClass> rate,
+                              bool onChange) 
 {
     std::lock_guard<std::mutex> lock(registersMutex);
     
+    std::string name = logName(reg.name, regMscId);
     auto it = std::find_if(registers.begin(), registers.end(),
-        [&regName](const RtRegisterInfo& info) { return info.name == regName; });
+        [&name](const RtRegisterInfo& info) { return info.name == name; });
     
     if (it != registers.end()) {
         return false;
     }
+    if (registers.size() >= MAX_REGISTERS) {
+        throw std::runtime_error("Cannot log more than " + std::to_string(MAX_REGISTERS) + " registers");
+    }
 
-    // Store FOC register using RT types but mark as FOC
+    // The id shares the RT field; the type keeps its own ST_MPC field
     RtRegisterInfo info{
-        static_cast<RT::RegisterId>(regId),
-        static_cast<RT::RegisterType>(type),
-        regName,
-        true  // true = FOC register
+        static_cast<RT::RegisterId>(reg.id),
+        RT::RegisterType::UInt8,
+        name,
+        true,  // true = FOC register
+        rate.value_or(defaultRateClass(reg.id)),
+        reg.type,
+        regMscId,
+        onChange
     };
     registers.push_back(info);
-    
-    if (running.load()) {
-        writeHeader();
-    }
-    
+    ++registersVersion;
     return true;
 }
 
-bool LoggerRt::removeRtRegister(const std::string& regName) 
+bool LoggerRt::removeRtRegister(const std::string& regName, uint8_t regMscId) 
 {
     std::lock_guard<std::mutex> lock(registersMutex);
     
+    std::string name = logName(regName, regMscId);
     auto it = std::find_if(registers.begin(), registers.end(),
-        [&regName](const RtRegisterInfo& info) { 
-            return info.name == regName && !info.isFoc; 
+        [&name](const RtRegisterInfo& info) { 
+            return info.name == name && !info.isFoc; 
         });
     
     if (it == registers.end()) {
@@ -120,21 +185,18 @@ bool LoggerRt::removeRtRegister(const std::string& regName)
     }
 
     registers.erase(it);
-    
-    if (running.load()) {
-        writeHeader();
-    }
-    
+    ++registersVersion;
     return true;
 }
 
-bool LoggerRt::removeFocRegister(const std::string& regName) 
+bool LoggerRt::removeFocRegister(const std::string& regName, uint8_t regMscId) 
 {
     std::lock_guard<std::mutex> lock(registersMutex);
     
+    std::string name = logName(regName, regMscId);
     auto it = std::find_if(registers.begin(), registers.end(),
-        [&regName](const RtRegisterInfo& info) { 
-            return info.name == regName && info.isFoc; 
+        [&name](const RtRegisterInfo& info) { 
+            return info.name == name && info.isFoc; 
         });
     
     if (it == registers.end()) {
@@ -142,204 +204,589 @@ bool LoggerRt::removeFocRegister(const std::string& regName)
     }
 
     registers.erase(it);
-    
-    if (running.load()) {
-        writeHeader();
-    }
-    
+    ++registersVersion;
     return true;
 }
 
-// Value extraction methods
-int32_t LoggerRt::extractRtValue(const std::vector<uint8_t>& response, RT::RegisterType type)
-{
-    if (response.size() < 17) {
-        throw std::runtime_error("Invalid response size");
-    }
-
-    switch (type) {
-        case RT::RegisterType::UInt8:
-            return response[16];
-            
-        case RT::RegisterType::Int16:
-            return static_cast<int16_t>(response[16] | (response[17] << 8));
-            
-        case RT::RegisterType::UInt16:
-            return static_cast<uint16_t>(response[16] | (response[17] << 8));
-            
-        case RT::RegisterType::Int32:
-            return static_cast<int32_t>(response[16] | (response[17] << 8) |
-                (response[18] << 16) | (response[19] << 24));
-            
-        case RT::RegisterType::UInt32:
-            return static_cast<uint32_t>(response[16] | (response[17] << 8) |
-                (response[18] << 16) | (response[19] << 24));
-            
-        case RT::RegisterType::Float: {
-            if (response.size() < 20) {
-                throw std::runtime_error("Invalid response size for float");
+// Value extraction; values keep their register type, strings are copied into the sample
+void LoggerRt::storeValue(size_t slot, const FrameInterpreterRt::Decoded& decoded)
+{
+    if (!decoded.ok()) {
+        throw std::runtime_error(interpreter.describeError(decoded));
+    }
+
+    LogValue& value = sample.values[slot];
+    if (auto v = std::get_if<int32_t>(&decoded.value)) {
+        value.i32 = *v;
+    } else if (auto v = std::get_if<uint32_t>(&decoded.value)) {
+        value.u32 = *v;
+    } else if (auto v = std::get_if<float>(&decoded.value)) {
+        value.f32 = *v;
+    } else if (auto v = std::get_if<std::string_view>(&decoded.value)) {
+        size_t length = std::min(v->size(), MAX_SAMPLE_TEXT - sample.textSize);
+        std::memcpy(sample.text.data() + sample.textSize, v->data(), length);
+        value.text = {sample.textSize, static_cast<uint16_t>(length)};
+        sample.textSize = static_cast<uint16_t>(sample.textSize + length);
+    } else {
+        throw std::runtime_error("Unsupported register type for value extraction");
+    }
+    sample.present[slot] = 1;
+}
+
+LogColumn LoggerRt::toColumn(const RtRegisterInfo& reg)
+{
+    LogColumnType type = LogColumnType::Int32;
+    switch (reg.isFoc ? RegisterTable::toRtType(reg.focType) : reg.type) {
+        case RT::RegisterType::UInt8:   type = LogColumnType::UInt8; break;
+        case RT::RegisterType::Int16:   type = LogColumnType::Int16; break;
+        case RT::RegisterType::UInt16:  type = LogColumnType::UInt16; break;
+        case RT::RegisterType::Int32:   type = LogColumnType::Int32; break;
+        case RT::RegisterType::UInt32:  type = LogColumnType::UInt32; break;
+        case RT::RegisterType::Float:   type = LogColumnType::Float32; break;
+        case RT::RegisterType::CharPtr: type = LogColumnType::String; break;
+    }
+    return {reg.name, type, static_cast<uint8_t>(reg.rate), reg.onChange};
+}
+
+void LoggerRt::compileReadFrames(const FrameBuilderRt& frameBuilder)
+{
+    activeRegisters = registers;
+    size_t count = activeRegisters.size();
+
+    // Number registers within each rate class so their reads land on different ticks
+    std::array<uint32_t, 3> classCount{};
+    activeSlots.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        activeSlots[i] = classCount[static_cast<size_t>(activeRegisters[i].rate)]++;
+    }
+
+    // Number the MSCs in the order their first register was added
+    std::array<int16_t, 256> mscIndex;
+    mscIndex.fill(-1);
+    activeMscCount = 0;
+    activeMscIndex.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto& index = mscIndex[activeRegisters[i].mscId];
+        if (index < 0) {
+            index = static_cast<int16_t>(activeMscCount++);
+        }
+        activeMscIndex[i] = static_cast<uint8_t>(index);
+    }
+
+    columns.clear();
+    for (const auto& reg : activeRegisters) {
+        columns.push_back(toColumn(reg));
+    }
+
+    readTemplates.resize(count);
+    requestFrames.resize(count);
+    requestViews.reserve(count);
+    dueRegisters.reserve(count);
+    dueRank.resize(count);
+    batchCounts.reserve(count);
+    batchEntries.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const auto& reg = activeRegisters[i];
+        if (reg.isFoc) {
+            frameBuilder.encodeFocReadFrame(readTemplates[i], reg.mscId, static_cast<ST_MPC::RegisterId>(reg.id));
+        } else {
+            frameBuilder.encodeReadFrame(readTemplates[i], reg.mscId, reg.id);
+        }
+    }
+}
+
+void LoggerRt::selectDueRegisters(uint64_t tick)
+{
+    uint64_t mediumDivider = std::max<uint32_t>(config.mediumDivider, 1);
+    uint64_t slowDivider = std::max<uint32_t>(config.slowDivider, 1);
+
+    dueRegisters.clear();
+    for (size_t i = 0; i < activeRegisters.size(); ++i) {
+        switch (activeRegisters[i].rate) {
+            case RateClass::Fast:
+                dueRegisters.push_back(i);
+                break;
+            case RateClass::Medium:
+                if (tick % mediumDivider == activeSlots[i] % mediumDivider) {
+                    dueRegisters.push_back(i);
+                }
+                break;
+            case RateClass::Slow:
+                if (tick % slowDivider == activeSlots[i] % slowDivider) {
+                    dueRegisters.push_back(i);
+                }
+                break;
+        }
+    }
+    if (activeMscCount > 1) {
+        interleaveDueRegisters();
+    }
+}
+
+// Reorder the due reads round-robin over the MSCs (A1 B1 A2 B2 ...), so consecutive
+// requests in the pipeline go to different MSCs and each one processes while the link
+// carries the next. Batch reads rotate whole batches instead of single registers.
+void LoggerRt::interleaveDueRegisters()
+{
+    size_t group = config.batchRead ? RT::MAX_BATCH_REGISTERS : 1;
+    std::array<uint32_t, 256> seen{};
+    for (size_t index : dueRegisters) {
+        uint32_t round = seen[activeMscIndex[index]]++ / static_cast<uint32_t>(group);
+        dueRank[index] = round * 256 + activeMscIndex[index];
+    }
+
+    // Stable insertion sort: at most MAX_REGISTERS entries and no allocation
+    for (size_t i = 1; i < dueRegisters.size(); ++i) {
+        size_t index = dueRegisters[i];
+        size_t j = i;
+        for (; j > 0 && dueRank[dueRegisters[j - 1]] > dueRank[index]; --j) {
+            dueRegisters[j] = dueRegisters[j - 1];
+        }
+        dueRegisters[j] = index;
+    }
+}
+
+void LoggerRt::prepareRequests(const FrameBuilderRt& frameBuilder)
+{
+    // Copy the precomputed read frames (or pack due registers into batches) and tag them
+    // so replies can be matched out of order
+    ++conversationId;
+    requestViews.clear();
+
+    if (config.batchRead) {
+        // A batch ends at MAX_BATCH_REGISTERS or where the next due register belongs to another MSC
+        std::array<FrameBuilderRt::BatchItem, RT::MAX_BATCH_REGISTERS> items;
+        batchCounts.clear();
+        size_t first = 0;
+        while (first < dueRegisters.size()) {
+            uint8_t frameMsc = activeRegisters[dueRegisters[first]].mscId;
+            size_t count = 0;
+            while (count < RT::MAX_BATCH_REGISTERS && first + count < dueRegisters.size()) {
+                const auto& reg = activeRegisters[dueRegisters[first + count]];
+                if (reg.mscId != frameMsc) {
+                    break;
+                }
+                items[count++] = {reg.isFoc ? RT::BatchSource::Foc : RT::BatchSource::Rt,
+                                  static_cast<uint8_t>(reg.id)};
             }
-            // Skip register ID byte (response[16]) and start from response[17]
-            uint32_t bits = static_cast<uint32_t>(response[17] | (response[18] << 8) |
-                                                (response[19] << 16) | (response[20] << 24));
-            float value = *reinterpret_cast<float*>(&bits);
-            return static_cast<int32_t>(value * 1000.0f);
+            auto& frame = requestFrames[requestViews.size()];
+            frameBuilder.encodeBatchReadFrame(frame, frameMsc, std::span(items.data(), count));
+            FrameBuilderRt::stampTransaction(frame, conversationId, static_cast<uint8_t>(requestViews.size() + 1));
+            requestViews.push_back(frame.view());
+            batchCounts.push_back(static_cast<uint8_t>(count));
+            first += count;
         }
-            
-        default:
-            throw std::runtime_error("Unsupported register type for value extraction");
+        return;
+    }
+
+    for (size_t index : dueRegisters) {
+        auto& frame = requestFrames[requestViews.size()];
+        frame = readTemplates[index];
+        FrameBuilderRt::stampTransaction(frame, conversationId, static_cast<uint8_t>(requestViews.size() + 1));
+        requestViews.push_back(frame.view());
     }
 }
 
-int32_t LoggerRt::extractFocValue(const std::vector<uint8_t>& response, ST_MPC::RegisterType type)
+void LoggerRt::recordTiming(std::chrono::steady_clock::time_point wake,
+                            std::chrono::steady_clock::time_point deadline,
+                            std::optional<std::chrono::steady_clock::time_point> lastWake)
 {
-    // FOC response format: [mscId, errorCode, ack, focPayloadLength, focPayload, focCrc]
-    if (response.size() < 20) {  // Minimum size for FOC response
-        throw std::runtime_error("Invalid FOC response size");
+    using Micros = std::chrono::duration<double, std::micro>;
+    double lateness = Micros(wake - deadline).count();
+
+    std::lock_guard<std::mutex> lock(timingMutex);
+    timing.ticks++;
+    timing.maxLatenessUs = std::max(timing.maxLatenessUs, lateness);
+    if (!lastWake) {
+        return;
     }
 
-    // FOC payload starts at index 20 (16 + 4)
-    const uint8_t* payload = response.data() + 20;
-    
-    switch (type) {
-        case ST_MPC::RegisterType::UInt8:
-            return payload[0];
-            
-        case ST_MPC::RegisterType::Int16:
-            return static_cast<int16_t>(payload[0] | (payload[1] << 8));
-            
-        case ST_MPC::RegisterType::UInt16:
-            return static_cast<uint16_t>(payload[0] | (payload[1] << 8));
-            
-        case ST_MPC::RegisterType::Int32:
-            return static_cast<int32_t>(payload[0] | (payload[1] << 8) |
-                (payload[2] << 16) | (payload[3] << 24));
-            
-        case ST_MPC::RegisterType::UInt32:
-            return static_cast<uint32_t>(payload[0] | (payload[1] << 8) |
-                (payload[2] << 16) | (payload[3] << 24));
-            
-        default:
-            throw std::runtime_error("Unsupported FOC register type for value extraction");
+    double period = Micros(wake - *lastWake).count();
+    uint64_t n = timing.ticks - 1;     // Periods measured so far, including this one
+    if (n == 1) {
+        timing.minPeriodUs = timing.maxPeriodUs = period;
+    } else {
+        timing.minPeriodUs = std::min(timing.minPeriodUs, period);
+        timing.maxPeriodUs = std::max(timing.maxPeriodUs, period);
+    }
+    double delta = period - timing.meanPeriodUs;
+    timing.meanPeriodUs += delta / static_cast<double>(n);
+    periodM2 += delta * (period - timing.meanPeriodUs);
+    timing.jitterUs = n > 1 ? std::sqrt(periodM2 / static_cast<double>(n - 1)) : 0.0;
+}
+
+void LoggerRt::extractValues()
+{
+    for (size_t i = 0; i < dueRegisters.size(); ++i) {
+        size_t slot = dueRegisters[i];
+        const auto& reg = activeRegisters[slot];
+        const auto& response = responses[i];
+        if (response.empty()) {
+            std::cerr << "Error reading " << reg.name << ": no reply" << std::endl;
+            continue;
+        }
+        try {
+            if (reg.isFoc) {
+                storeValue(slot, FrameInterpreterRt::decode(response, reg.focType));
+            } else {
+                storeValue(slot, FrameInterpreterRt::decode(response, reg.type));
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error reading " << reg.name << ": " << e.what() << std::endl;
+        }
+    }
+}
+
+void LoggerRt::extractBatchValues()
+{
+    size_t first = 0;
+    for (size_t frame = 0; frame < responses.size(); first += batchCounts[frame], ++frame) {
+        size_t count = batchCounts[frame];
+        std::span<FrameInterpreterRt::BatchEntry> entries(batchEntries.data() + first, count);
+
+        const auto& response = responses[frame];
+        if (response.empty()) {
+            std::cerr << "Error reading batch " << frame + 1 << ": no reply" << std::endl;
+            continue;
+        }
+        auto batch = FrameInterpreterRt::decodeBatch(response, entries);
+        if (!batch.ok()) {
+            std::cerr << "Error reading batch " << frame + 1 << ": " << interpreter.describeError(batch) << std::endl;
+            continue;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            size_t slot = dueRegisters[first + i];
+            const auto& reg = activeRegisters[slot];
+            auto decoded = reg.isFoc
+                ? FrameInterpreterRt::decodeBatchEntry(entries[i], reg.focType)
+                : FrameInterpreterRt::decodeBatchEntry(entries[i], reg.type);
+            try {
+                storeValue(slot, decoded);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Error reading " << reg.name << ": " << e.what() << std::endl;
+            }
+        }
     }
 }
 
 void LoggerRt::loggingThread() 
 {
+    using Clock = std::chrono::steady_clock;
+
     FrameBuilderRt frameBuilder;
+    uint32_t activeVersion = 0;
+    const auto period = std::chrono::duration_cast<Clock::duration>(config.sampleInterval);
+    auto deadline = Clock::now();
+    std::optional<Clock::time_point> lastWake;
+    uint64_t tick = 0;
     
     while (running.load()) {
+        // Sleep to an absolute deadline so read time does not stretch the period
+        std::this_thread::sleep_until(deadline);
+        auto wake = Clock::now();
+        recordTiming(wake, deadline, lastWake);
+        lastWake = wake;
+
         try {
             auto timestamp = std::chrono::system_clock::now();
-            std::map<std::string, int32_t> values;
 
-            // Take a snapshot of registers with minimal lock time
-            std::vector<RtRegisterInfo> regs;
+            bool schemaChanged = false;
             {
                 std::lock_guard<std::mutex> lock(registersMutex);
-                regs = registers;
+                if (activeVersion != registersVersion) {
+                    compileReadFrames(frameBuilder);
+                    activeVersion = registersVersion;
+                    schemaChanged = true;
+                }
             }
-
-            if (regs.empty()) {
-                std::this_thread::sleep_for(config.sampleInterval);
-                continue;
+            if (schemaChanged) {
+                // Queued before any sample that uses it, so the writer always finds it
+                std::lock_guard<std::mutex> lock(schemaMutex);
+                pendingSchemas.emplace_back(activeVersion, columns);
+            }
+            if (schemaChanged && telemetry.isOpen()) {
+                telemetry.setChannels(columns, activeVersion);
             }
 
-            // Read all registers without locking
-            for (const auto& reg : regs) {
-                try {
-                    std::vector<uint8_t> frame;
-                    if (reg.isFoc) {
-                        // Build FOC read frame
-                        frame = frameBuilder.buildFocReadFrame(mscId, 
-                            static_cast<ST_MPC::RegisterId>(reg.id));
-                    } else {
-                        // Build RT read frame
-                        frame = frameBuilder.buildReadFrame(mscId, reg.id);
-                    }
-                    
-                    std::lock_guard<std::mutex> lock(readMutex);
-                    serial.sendFrame(frame);
-                    auto response = serial.readFrame();
-
-                    if (response.size() >= 17) {  // Minimum valid response size
-                        if (reg.isFoc) {
-                            values[reg.name] = extractFocValue(response, 
-                                static_cast<ST_MPC::RegisterType>(reg.type));
-                        } else {
-                            values[reg.name] = extractRtValue(response, reg.type);
-                        }
-                    }
+            selectDueRegisters(tick);
+            if (!dueRegisters.empty()) {
+                sample.timestamp = timestamp;
+                sample.schemaVersion = activeVersion;
+                // Clear every slot: a removed register may have left its flag set
+                sample.present.fill(0);
+                sample.textSize = 0;
+                prepareRequests(frameBuilder);
+                serial.transactPipelined(requestViews, responses, config.pipelineDepth);
+
+                if (config.batchRead) {
+                    extractBatchValues();
+                } else {
+                    extractValues();
                 }
-                catch (const std::exception& e) {
-                    std::cerr << "Error reading " << reg.name << ": " << e.what() << std::endl;
-                }
-            }
 
-            // Write values if we got any
-            if (!values.empty()) {
-                writeLogLine(timestamp, values);
+                // Queue values if we got any
+                size_t count = activeRegisters.size();
+                auto presentEnd = sample.present.begin() + count;
+                if (std::find(sample.present.begin(), presentEnd, 1) != presentEnd) {
+                    pushSample();
+                    if (telemetry.isOpen()) {
+                        telemetry.publish(timestamp, std::span(sample.values.data(), count),
+                                          std::span(sample.present.data(), count));
+                    }
+                }
             }
-
-            std::this_thread::sleep_for(config.sampleInterval);
         }
         catch (const std::exception& e) {
             std::cerr << "Logger error: " << e.what() << std::endl;
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
+
+        // Skip ticks whose deadline already passed instead of bursting to catch up
+        deadline += period;
+        ++tick;
+        auto now = Clock::now();
+        if (now > deadline) {
+            auto missed = static_cast<uint64_t>((now - deadline) / period) + 1;
+            deadline += period * missed;
+            tick += missed;
+            std::lock_guard<std::mutex> lock(timingMutex);
+            timing.overruns += missed;
+        }
     }
 }
 
-void LoggerRt::writeHeader() 
+void LoggerRt::pushSample()
 {
-    std::lock_guard<std::mutex> lock(registersMutex);
-    logFile.seekp(0);
-    logFile.clear();
-
-    if (registers.empty()) {
+    // Never blocks: a full queue means the writer is behind, so the sample is dropped
+    if (!queue->tryPush(sample)) {
+        queueOverflows.fetch_add(1, std::memory_order_relaxed);
         return;
     }
+    size_t fill = queue->size();
+    if (fill > queueMaxFill.load(std::memory_order_relaxed)) {
+        queueMaxFill.store(fill, std::memory_order_relaxed);
+    }
+}
+
+void LoggerRt::writeSamples()
+{
+    constexpr auto IDLE_WAIT = std::chrono::milliseconds(5);
+
+    while (true) {
+        bool draining = !writerRunning.load();
 
-    if (config.useTimestamp) {
-        logFile << "Timestamp";
+        while (const SampleRecord* record = queue->front()) {
+            try {
+                if (record->schemaVersion != receivedVersion) {
+                    receiveSchema(record->schemaVersion);
+                }
+                if (config.capture.enabled) {
+                    captureSample(*record);
+                } else {
+                    writeSample(*record);
+                }
+            }
+            catch (const std::exception& e) {
+                writeErrors.fetch_add(1, std::memory_order_relaxed);
+                std::cerr << "Log write error: " << e.what() << std::endl;
+            }
+            queue->pop();
+        }
+
+        if (draining) {
+            break;
+        }
+        std::this_thread::sleep_for(IDLE_WAIT);
     }
+}
 
-    for (const auto& reg : registers) {
-        if (config.useTimestamp || &reg != &registers.front()) {
-            logFile << ",";
+void LoggerRt::receiveSchema(uint32_t version)
+{
+    std::vector<LogColumn> schema;
+    {
+        std::lock_guard<std::mutex> lock(schemaMutex);
+        while (!pendingSchemas.empty() && pendingSchemas.front().first != version) {
+            pendingSchemas.pop_front();
         }
-        logFile << reg.name;
+        if (!pendingSchemas.empty()) {
+            schema = std::move(pendingSchemas.front().second);
+            pendingSchemas.pop_front();
+        }
+    }
+    receivedVersion = version;
+
+    // Older schemas are kept only while captured samples still refer to them
+    uint32_t oldest = version;
+    for (size_t i = 0; i < ringCount; ++i) {
+        oldest = std::min(oldest, captureRing[(ringNext + captureRing.size() - ringCount + i) % captureRing.size()].schemaVersion);
     }
-    logFile << "\n";
-    logFile.flush();
+    while (!writerSchemas.empty() && writerSchemas.front().first < oldest) {
+        writerSchemas.pop_front();
+    }
+    writerSchemas.emplace_back(version, std::move(schema));
+
+    // Trigger columns follow the names, so they survive register changes
+    const auto& columns = writerSchemas.back().second;
+    statusColumns.clear();
+    thresholdIndex.reset();
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const auto& name = columns[i].name;
+        if (name == "status" || name.rfind("status@", 0) == 0) {
+            statusColumns.push_back(i);
+        }
+        if (!config.capture.thresholdColumn.empty() && name == config.capture.thresholdColumn) {
+            thresholdIndex = i;
+        }
+    }
+    lastStatus.assign(statusColumns.size(), static_cast<uint32_t>(ST_MPC::Status::FaultNow));
+    haveThresholdValue = false;
 }
 
-void LoggerRt::writeLogLine(const std::chrono::system_clock::time_point& timestamp,
-                           const std::map<std::string, int32_t>& values) 
+const std::vector<LogColumn>& LoggerRt::schemaOf(uint32_t version) const
 {
-    if (config.useTimestamp) {
-        auto ts = std::chrono::duration_cast<std::chrono::microseconds>(
-            timestamp.time_since_epoch()).count();
-        logFile << ts;
+    static const std::vector<LogColumn> none;
+    for (const auto& [schemaVersion, columns] : writerSchemas) {
+        if (schemaVersion == version) {
+            return columns;
+        }
     }
+    return none;
+}
 
-    std::lock_guard<std::mutex> lock(registersMutex);
-    for (const auto& reg : registers) {
-        if (config.useTimestamp || &reg != &registers.front()) {
-            logFile << ",";
-        }
-        auto it = values.find(reg.name);
-        if (it != values.end()) {
-            if (reg.type == RT::RegisterType::Float) {
-                // Convert back from fixed-point to decimal
-                logFile << std::fixed << std::setprecision(3) << (it->second / 1000.0);
+void LoggerRt::writeSample(const SampleRecord& record)
+{
+    const auto& columns = schemaOf(record.schemaVersion);
+    if (record.schemaVersion != writtenVersion) {
+        writer->writeSchema(columns);
+        writtenVersion = record.schemaVersion;
+
+        // Every column is written in full after a header
+        lastWritten.assign(columns.size(), WrittenValue{});
+        hasOnChangeColumns = std::any_of(columns.begin(), columns.end(),
+            [](const LogColumn& column) { return column.onChange; });
+    }
+
+    std::span<const uint8_t> present(record.present.data(), columns.size());
+    if (hasOnChangeColumns) {
+        if (!filterUnchanged(record, columns)) {
+            return;
+        }
+        present = std::span<const uint8_t>(changedPresent.data(), columns.size());
+    }
+    writer->writeRow({record.timestamp,
+                      std::span(record.values.data(), columns.size()),
+                      present,
+                      std::string_view(record.text.data(), record.textSize)});
+    samplesWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Fills changedPresent without the on-change columns that need no record; false when no column is left
+bool LoggerRt::filterUnchanged(const SampleRecord& record, const std::vector<LogColumn>& columns)
+{
+    bool any = false;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        changedPresent[i] = record.present[i];
+        if (columns[i].onChange && record.present[i]) {
+            const LogValue& value = record.values[i];
+            auto& last = lastWritten[i];
+            bool isText = columns[i].type == LogColumnType::String;
+            std::string_view text = isText
+                ? std::string_view(record.text.data() + value.text.offset, value.text.length)
+                : std::string_view();
+
+            bool unchanged = last.valid && (isText ? last.text == text : last.value.u32 == value.u32);
+            bool keepAliveDue = config.keepAlive.count() > 0 && record.timestamp - last.at >= config.keepAlive;
+            if (unchanged && !keepAliveDue) {
+                changedPresent[i] = 0;
             } else {
-                logFile << it->second;
+                last.value = value;
+                last.text.assign(text);
+                last.at = record.timestamp;
+                last.valid = true;
+            }
+        }
+        any |= changedPresent[i] != 0;
+    }
+    return any;
+}
+
+void LoggerRt::captureSample(const SampleRecord& record)
+{
+    if (postRemaining > 0) {
+        writeSample(record);
+        if (--postRemaining == 0) {
+            recording.store(false);
+        }
+        return;
+    }
+
+    auto reason = checkTriggers(record);
+    if (!reason) {
+        if (!captureRing.empty()) {
+            captureRing[ringNext] = record;
+            ringNext = (ringNext + 1) % captureRing.size();
+            ringCount = std::min(ringCount + 1, captureRing.size());
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(captureMutex);
+        lastTrigger = *reason;
+    }
+    captures.fetch_add(1, std::memory_order_relaxed);
+
+    // Every capture starts with a header, which separates consecutive windows in the file
+    writtenVersion = 0;
+    for (size_t i = 0; i < ringCount; ++i) {
+        writeSample(captureRing[(ringNext + captureRing.size() - ringCount + i) % captureRing.size()]);
+    }
+    ringCount = 0;
+    writeSample(record);
+    postRemaining = config.capture.postSamples;
+    recording.store(postRemaining > 0);
+}
+
+std::optional<std::string> LoggerRt::checkTriggers(const SampleRecord& record)
+{
+    std::optional<std::string> reason;
+    if (manualTrigger.exchange(false)) {
+        reason = "manual";
+    }
+
+    const auto& columns = schemaOf(record.schemaVersion);
+    const auto& capture = config.capture;
+    for (size_t k = 0; k < statusColumns.size(); ++k) {
+        size_t i = statusColumns[k];
+        if (!record.present[i]) {
+            continue;
+        }
+        uint32_t status = record.values[i].u32;
+        auto fault = static_cast<uint32_t>(ST_MPC::Status::FaultNow);
+        if (capture.onFault && !reason && status == fault && lastStatus[k] != fault) {
+            reason = "fault in " + columns[i].name;
+        }
+        lastStatus[k] = status;
+    }
+
+    if (thresholdIndex && record.present[*thresholdIndex]) {
+        size_t i = *thresholdIndex;
+        double value = numericValue(record.values[i], columns[i].type);
+        if (haveThresholdValue && !reason) {
+            bool rising = lastThresholdValue < capture.level && value >= capture.level;
+            bool falling = lastThresholdValue > capture.level && value <= capture.level;
+            if ((rising && capture.edge != Edge::Falling) || (falling && capture.edge != Edge::Rising)) {
+                reason = columns[i].name + (rising ? " rising" : " falling") + " through " + std::to_string(capture.level);
             }
         }
+        lastThresholdValue = value;
+        haveThresholdValue = !std::isnan(value);
     }
-    logFile << "\n";
-    logFile.flush();
+    return reason;
 }
 
 void LoggerRt::setConfig(const LogConfig& newConfig) 
@@ -348,7 +795,6 @@ void LoggerRt::setConfig(const LogConfig& newConfig)
         throw std::runtime_error("Cannot change config while logger is running");
     }
     config = newConfig;
-    fileOpened = false;  // Force file to be reopened with new name
 }
 
 const LoggerRt::LogConfig& LoggerRt::getConfig() const 
@@ -364,7 +810,124 @@ std::vector<std::string> LoggerRt::getLoggedRegisters() const
     for (const auto& reg : registers) {
         // Include type (RT or FOC) in the register name
         std::string prefix = reg.isFoc ? "FOC: " : "RT:  ";
-        names.push_back(prefix + reg.name);
+        names.push_back(prefix + reg.name + " (" + rateClassName(reg.rate) + (reg.onChange ? ", on change)" : ")"));
     }
     return names;
-}
\ No newline at end of file
+}
+
+LoggerRt::TimingStats LoggerRt::getTimingStats() const
+{
+    std::lock_guard<std::mutex> lock(timingMutex);
+    return timing;
+}
+
+LoggerRt::CaptureStats LoggerRt::getCaptureStats() const
+{
+    CaptureStats stats;
+    stats.captures = captures.load();
+    stats.recording = recording.load();
+    std::lock_guard<std::mutex> lock(captureMutex);
+    stats.lastTrigger = lastTrigger;
+    return stats;
+}
+
+void LoggerRt::trigger()
+{
+    manualTrigger.store(true);
+}
+
+LoggerRt::QueueStats LoggerRt::getQueueStats() const
+{
+    QueueStats stats;
+    stats.capacity = queue ? queue->capacity() : config.queueCapacity;
+    stats.maxFill = queueMaxFill.load();
+    stats.written = samplesWritten.load();
+    stats.overflows = queueOverflows.load();
+    stats.writeErrors = writeErrors.load();
+    return stats;
+}
+
+LoggerRt::RateClass LoggerRt::defaultRateClass(RT::RegisterId regId)
+{
+    switch (regId) {
+        case RT::RegisterId::CURRENT_SPEED:
+        case RT::RegisterId::SPEED_SETPOINT:
+            return RateClass::Medium;
+        default:
+            return RateClass::Slow;
+    }
+}
+
+LoggerRt::RateClass LoggerRt::defaultRateClass(ST_MPC::RegisterId regId)
+{
+    switch (regId) {
+        case ST_MPC::RegisterId::Ia:
+        case ST_MPC::RegisterId::Ib:
+        case ST_MPC::RegisterId::Ialpha:
+        case ST_MPC::RegisterId::Ibeta:
+        case ST_MPC::RegisterId::Iq:
+        case ST_MPC::RegisterId::Id:
+        case ST_MPC::RegisterId::IqRef:
+        case ST_MPC::RegisterId::IdRef:
+        case ST_MPC::RegisterId::Vq:
+        case ST_MPC::RegisterId::Vd:
+        case ST_MPC::RegisterId::Valpha:
+        case ST_MPC::RegisterId::Vbeta:
+        case ST_MPC::RegisterId::ElAngleMeas:
+        case ST_MPC::RegisterId::IqRefSpeedMode:
+            return RateClass::Fast;
+        case ST_MPC::RegisterId::SpeedRef:
+        case ST_MPC::RegisterId::SpeedMeas:
+        case ST_MPC::RegisterId::TorqueRef:
+        case ST_MPC::RegisterId::TorqueMeas:
+        case ST_MPC::RegisterId::FluxRef:
+        case ST_MPC::RegisterId::FluxMeas:
+        case ST_MPC::RegisterId::MotorPower:
+            return RateClass::Medium;
+        default:
+            return RateClass::Slow;
+    }
+}
+
+const char* LoggerRt::rateClassName(RateClass rate)
+{
+    switch (rate) {
+        case RateClass::Fast:   return "fast";
+        case RateClass::Medium: return "medium";
+        default:                return "slow";
+    }
+}
+
+LoggerRt::LogFormat LoggerRt::formatForFile(const std::string& filename)
+{
+    const std::string extension = ".rtlog";
+    if (filename.size() >= extension.size() &&
+        filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0) {
+        return LogFormat::Binary;
+    }
+    return LogFormat::Csv;
+}
+
+std::optional<LoggerRt::RateClass> LoggerRt::parseRateClass(const std::string& name)
+{
+    if (name == "fast") return RateClass::Fast;
+    if (name == "medium") return RateClass::Medium;
+    if (name == "slow") return RateClass::Slow;
+    return std::nullopt;
+}
+std::optional<LoggerRt::Edge> LoggerRt::parseEdge(const std::string& name)
+{
+    if (name == "rising") return Edge::Rising;
+    if (name == "falling") return Edge::Falling;
+    if (name == "either") return Edge::Either;
+    return std::nullopt;
+}
+
+const char* LoggerRt::edgeName(Edge edge)
+{
+    switch (edge) {
+        case Edge::Rising:  return "rising";
+        case Edge::Falling: return "falling";
+        default:            return "either";
+    }
+}
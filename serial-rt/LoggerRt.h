@@ -3,14 +3,23 @@
 #define LOGGER_RT_H
 
 #include "SerialConnectionRt.h"
+#include "FrameBuilderRt.h"
+#include "FrameInterpreterRt.h"
+#include "LogFileRt.h"
 #include "RtDefinitions.h"
+#include "SpscRing.h"
+#include "TelemetryFeedRt.h"
 #include "StMpcDefinitions.h"
+#include "RegisterTableRt.h"
+#include <array>
 #include <atomic>
 #include <chrono>
-#include <fstream>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <map>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 #include <variant>
@@ -18,20 +27,103 @@
 class LoggerRt 
 {
 public:
+    static constexpr size_t MAX_REGISTERS = 64;
+    static constexpr size_t MAX_SAMPLE_TEXT = 256;     // Bytes of string values per sample
+    static constexpr size_t MAX_CAPTURE_SAMPLES = 100000;   // Per window, bounds the ring at ~60 MB
+
+    // Fast registers are read every tick, Medium/Slow every mediumDivider/slowDivider ticks
+    enum class RateClass : uint8_t
+    {
+        Fast,       // Phase currents, voltages, angle
+        Medium,     // Speed, torque, references
+        Slow        // Temperatures, flags, configuration
+    };
+
+    enum class LogFormat : uint8_t
+    {
+        Csv,        // Text, readable live by plot.py
+        Binary      // Columnar .rtlog, see BinaryLogWriterRt
+    };
+
+    // Armed capture: every sample is kept in a ring in memory and nothing is written until a
+    // trigger fires; then the preSamples before it, the triggering sample and postSamples after
+    // it are written and the capture arms again. Triggers: a FOC status column entering FaultNow,
+    // a threshold crossing on one column, or trigger() (log-trigger).
+    enum class Edge : uint8_t
+    {
+        Rising,
+        Falling,
+        Either
+    };
+
+    struct CaptureConfig
+    {
+        bool enabled{false};
+        size_t preSamples{100};
+        size_t postSamples{100};
+        bool onFault{false};
+        std::string thresholdColumn;    // Logged name, e.g. "Ia" or "Ia@2"; empty = none
+        Edge edge{Edge::Rising};
+        double level{0.0};
+    };
+
+    struct CaptureStats
+    {
+        uint64_t captures{0};       // Triggers fired
+        bool recording{false};      // Writing the post-trigger window
+        std::string lastTrigger;
+    };
+
     struct LogConfig 
     {
         std::string filename;
-        std::chrono::milliseconds sampleInterval{100};
+        std::chrono::milliseconds sampleInterval{100};  // Base tick (Fast rate)
+        uint32_t mediumDivider{10};
+        uint32_t slowDivider{100};
         size_t bufferSize{1024};
         bool useTimestamp{true};
+        size_t pipelineDepth{4};    // Register reads kept in flight per sample
+        bool batchRead{false};      // One RT_BATCH_READ per MAX_BATCH_REGISTERS registers
+        LogFormat format{LogFormat::Csv};
+        size_t queueCapacity{4096}; // Samples buffered between acquisition and the writer thread
+        std::string telemetryName{"/rtif-telemetry"};  // Shared memory live feed, empty disables
+        uint64_t segmentBytes{0};                   // Rotate into numbered segment files, 0 = one file
+        std::chrono::seconds segmentDuration{0};    // Also rotate after this long, 0 = size only
+        uint64_t diskBudget{0};                     // Delete the oldest segments beyond this, 0 = keep all
+        CaptureConfig capture{};
+        std::chrono::seconds keepAlive{10};     // On-change registers are written at least this often, 0 = only on change
     };
 
     struct RtRegisterInfo 
     {
-        RT::RegisterId id;
-        RT::RegisterType type;
+        RT::RegisterId id;          // ST_MPC::RegisterId value for FOC registers
+        RT::RegisterType type;      // RT registers only
         std::string name;
         bool isFoc;  // false for RT, true for FOC
+        RateClass rate{RateClass::Fast};
+        ST_MPC::RegisterType focType{ST_MPC::RegisterType::UInt8};     // FOC registers only
+        uint8_t mscId{0};
+        bool onChange{false};       // Written only when it changes, see LogConfig::keepAlive
+    };
+
+    struct TimingStats
+    {
+        uint64_t ticks{0};
+        uint64_t overruns{0};       // Ticks skipped because their deadline had passed
+        double meanPeriodUs{0.0};
+        double minPeriodUs{0.0};
+        double maxPeriodUs{0.0};
+        double jitterUs{0.0};       // Standard deviation of the achieved period
+        double maxLatenessUs{0.0};  // Worst wake-up delay behind a deadline
+    };
+
+    struct QueueStats
+    {
+        size_t capacity{0};
+        size_t maxFill{0};          // High-water mark of queued samples
+        uint64_t written{0};
+        uint64_t overflows{0};      // Samples dropped because the queue was full
+        uint64_t writeErrors{0};    // Samples dropped because the log file write failed
     };
 
     LoggerRt(SerialConnectionRt& serial, uint8_t mscId, const LogConfig& config);
@@ -41,39 +133,152 @@ public:
     void stop();
     bool isRunning() const;
     
-    // RT register handling
-    bool addRtRegister(const std::string& regName, RT::RegisterId regId, RT::RegisterType type);
-    bool removeRtRegister(const std::string& regName);
+    // Registers may come from any MSC on the bus; those of other MSCs than the logger's
+    // own are logged as name@msc, and reads are interleaved across MSCs
+    // An on-change register is read at its rate like any other, but its column is left empty in
+    // rows where its value equals the last one written, unless keepAlive has passed since; rows
+    // with nothing left to write are skipped
+    bool addRtRegister(const RegisterTable::RtRegister& reg, uint8_t regMscId,
+                       std::optional<RateClass> rate = std::nullopt, bool onChange = false);
+    bool removeRtRegister(const std::string& regName, uint8_t regMscId);
     
-    // FOC register handling
-    bool addFocRegister(const std::string& regName, ST_MPC::RegisterId regId, ST_MPC::RegisterType type);
-    bool removeFocRegister(const std::string& regName);
+    bool addFocRegister(const RegisterTable::FocRegister& reg, uint8_t regMscId,
+                        std::optional<RateClass> rate = std::nullopt, bool onChange = false);
+    bool removeFocRegister(const std::string& regName, uint8_t regMscId);
     
     void setConfig(const LogConfig& newConfig);
     const LogConfig& getConfig() const;
     std::vector<std::string> getLoggedRegisters() const;
+    TimingStats getTimingStats() const;
+    QueueStats getQueueStats() const;
+    CaptureStats getCaptureStats() const;
+    void trigger();                 // Manual capture trigger
+
+    static RateClass defaultRateClass(RT::RegisterId regId);
+    static RateClass defaultRateClass(ST_MPC::RegisterId regId);
+    static const char* rateClassName(RateClass rate);
+    static std::optional<RateClass> parseRateClass(const std::string& name);
+    static std::optional<Edge> parseEdge(const std::string& name);
+    static const char* edgeName(Edge edge);
+    static LogFormat formatForFile(const std::string& filename);   // ".rtlog" selects Binary
 
 private:
     SerialConnectionRt& serial;
     uint8_t mscId;
+    FrameInterpreterRt interpreter;     // Error text only; decoding is static
     LogConfig config;
-    std::ofstream logFile;
-    bool fileOpened{false};
+    std::unique_ptr<LogWriterRt> writer;
 
     std::atomic<bool> running{false};
     std::thread loggerThread;
+    std::thread writerThread;
+    std::atomic<bool> writerRunning{false};
     std::vector<RtRegisterInfo> registers;
+    uint32_t registersVersion{1};   // Bumped whenever registers changes
+    uint8_t conversationId{0};
     
-    static std::mutex readMutex;
     mutable std::mutex registersMutex;
 
-    int32_t extractRtValue(const std::vector<uint8_t>& response, RT::RegisterType type);
-    int32_t extractFocValue(const std::vector<uint8_t>& response, ST_MPC::RegisterType type);
+    // Acquisition state owned by the logging thread, rebuilt only when registers change
+    std::vector<RtRegisterInfo> activeRegisters;
+    std::vector<uint32_t> activeSlots;      // Position within the rate class, spreads slow reads over ticks
+    std::vector<size_t> dueRegisters;       // Indices into activeRegisters read this tick
+    std::vector<uint8_t> activeMscIndex;    // Order of the register's MSC among the logged MSCs
+    size_t activeMscCount{0};
+    std::vector<uint32_t> dueRank;          // Interleave position per register, scratch for this tick
+    std::vector<uint8_t> batchCounts;       // Registers in each batch frame, in dueRegisters order
+    std::vector<FrameBuilderRt::EncodedFrame> readTemplates;
+    std::vector<FrameBuilderRt::EncodedFrame> requestFrames;
+    std::vector<std::span<const uint8_t>> requestViews;
+    std::vector<std::vector<uint8_t>> responses;
+    std::vector<FrameInterpreterRt::BatchEntry> batchEntries;
+    std::vector<LogColumn> columns;
+
+    // Fixed-size sample handed from the logging thread to the writer thread;
+    // values are indexed like the columns of schemaVersion
+    struct SampleRecord
+    {
+        std::chrono::system_clock::time_point timestamp;
+        uint32_t schemaVersion{0};
+        std::array<LogValue, MAX_REGISTERS> values{};
+        std::array<uint8_t, MAX_REGISTERS> present{};
+        uint16_t textSize{0};
+        std::array<char, MAX_SAMPLE_TEXT> text{};
+    };
+
+    static_assert(MAX_REGISTERS <= TelemetryFeedRt::MAX_CHANNELS);
+
+    SampleRecord sample;
+    TelemetryFeedRt telemetry;
+    std::unique_ptr<SpscRing<SampleRecord>> queue;
+    std::deque<std::pair<uint32_t, std::vector<LogColumn>>> pendingSchemas;    // Column sets not yet written
+    std::mutex schemaMutex;
+
+    std::atomic<size_t> queueMaxFill{0};
+    std::atomic<uint64_t> samplesWritten{0};
+    std::atomic<uint64_t> queueOverflows{0};
+    std::atomic<uint64_t> writeErrors{0};
+
+    // Writer thread state: schemas by version, still needed by queued or captured samples
+    std::deque<std::pair<uint32_t, std::vector<LogColumn>>> writerSchemas;
+    uint32_t receivedVersion{0};
+    uint32_t writtenVersion{0};
+
+    // On-change columns: the last value written per column of writtenVersion
+    struct WrittenValue
+    {
+        LogValue value{};
+        std::string text;
+        std::chrono::system_clock::time_point at;
+        bool valid{false};
+    };
+    std::vector<WrittenValue> lastWritten;
+    std::array<uint8_t, MAX_REGISTERS> changedPresent{};
+    bool hasOnChangeColumns{false};
+
+    // Capture state, owned by the writer thread except where noted
+    std::vector<SampleRecord> captureRing;  // Pre-trigger samples, allocated by start()
+    size_t ringNext{0};
+    size_t ringCount{0};
+    size_t postRemaining{0};
+    std::vector<size_t> statusColumns;      // FOC status columns of the current schema
+    std::vector<uint32_t> lastStatus;
+    std::optional<size_t> thresholdIndex;
+    double lastThresholdValue{0.0};
+    bool haveThresholdValue{false};
+    std::atomic<bool> manualTrigger{false};
+    std::atomic<uint64_t> captures{0};
+    std::atomic<bool> recording{false};
+    std::string lastTrigger;
+    mutable std::mutex captureMutex;        // Guards lastTrigger
+
+    TimingStats timing;
+    double periodM2{0.0};   // Running sum of squared period deviations (Welford)
+    mutable std::mutex timingMutex;
+
+    void compileReadFrames(const FrameBuilderRt& frameBuilder);
+    void selectDueRegisters(uint64_t tick);
+    void interleaveDueRegisters();
+    void prepareRequests(const FrameBuilderRt& frameBuilder);
+    void recordTiming(std::chrono::steady_clock::time_point wake,
+                      std::chrono::steady_clock::time_point deadline,
+                      std::optional<std::chrono::steady_clock::time_point> lastWake);
+    void extractValues();
+    void extractBatchValues();
+
+    void storeValue(size_t slot, const FrameInterpreterRt::Decoded& decoded);
+    static LogColumn toColumn(const RtRegisterInfo& reg);
+    std::string logName(std::string_view regName, uint8_t regMscId) const;
 
     void loggingThread();
-    void writeHeader();
-    void writeLogLine(const std::chrono::system_clock::time_point& timestamp, 
-                     const std::map<std::string, int32_t>& values);
+    void writeSamples();
+    void pushSample();
+    void receiveSchema(uint32_t version);
+    const std::vector<LogColumn>& schemaOf(uint32_t version) const;
+    void writeSample(const SampleRecord& record);
+    bool filterUnchanged(const SampleRecord& record, const std::vector<LogColumn>& columns);
+    void captureSample(const SampleRecord& record);
+    std::optional<std::string> checkTriggers(const SampleRecord& record);
 };
 
 #endif // LOGGER_RT_H
\ No newline at end of file
@@ -0,0 +1,270 @@
+// RegisterTableRt.h
+#ifndef REGISTER_TABLE_RT_H
+#define REGISTER_TABLE_RT_H
+
+#include "RtDefinitions.h"
+#include "StMpcDefinitions.h"
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// Names, ids and types of every RT/FOC register and execute command known to the CLI
+// and the logger. The tables are constexpr and each has a perfect hash built at compile
+// time, so a lookup is one hash, one slot load and one string compare. Duplicate names
+// make the hash build fail and stop the compile.
+namespace RegisterTable
+{
+    // Extra text the CLI prints after a read value
+    enum class Display : uint8_t
+    {
+        Raw,
+        GdrTemperature,     // Gate driver temperature in degrees C
+        ControlMode         // Torque/Speed
+    };
+
+    struct RtRegister
+    {
+        std::string_view name;
+        RT::RegisterId id;
+        RT::RegisterType type;
+    };
+
+    struct FocRegister
+    {
+        std::string_view name;
+        ST_MPC::RegisterId id;
+        ST_MPC::RegisterType type;
+        Display display{Display::Raw};
+    };
+
+    struct RtExecute
+    {
+        std::string_view name;
+        RT::ExecuteId id;
+    };
+
+    struct FocExecute
+    {
+        std::string_view name;
+        ST_MPC::ExecuteId id;
+    };
+
+    inline constexpr std::array RT_REGISTERS = {
+        RtRegister{"rt-ramp-final-speed", RT::RegisterId::RAMP_FINAL_SPEED, RT::RegisterType::Int32},
+        RtRegister{"rt-ramp-duration", RT::RegisterId::RAMP_DURATION, RT::RegisterType::UInt16},
+        RtRegister{"rt-speed-ref", RT::RegisterId::SPEED_SETPOINT, RT::RegisterType::Float},
+        RtRegister{"rt-speed-Kp", RT::RegisterId::SPEED_KP, RT::RegisterType::Float},
+        RtRegister{"rt-speed-Ki", RT::RegisterId::SPEED_KI, RT::RegisterType::Float},
+        RtRegister{"rt-speed-Kd", RT::RegisterId::SPEED_KD, RT::RegisterType::Float},
+        RtRegister{"rt-board-info", RT::RegisterId::BOARD_INFO, RT::RegisterType::CharPtr},
+        RtRegister{"rt-speed-meas", RT::RegisterId::CURRENT_SPEED, RT::RegisterType::Float},
+        RtRegister{"rt-speed-loop-period", RT::RegisterId::SPEED_LOOP_PERIOD_MS, RT::RegisterType::UInt32},
+        RtRegister{"rt-git-version", RT::RegisterId::GIT_VERSION, RT::RegisterType::CharPtr}
+    };
+
+    inline constexpr std::array RT_EXECUTES = {
+        RtExecute{"start", RT::ExecuteId::START_MOTOR},
+        RtExecute{"stop", RT::ExecuteId::STOP_MOTOR},
+        RtExecute{"ramp", RT::ExecuteId::RAMP_EXECUTE},
+        RtExecute{"feedback-start", RT::ExecuteId::START_FEEDBACK},
+        RtExecute{"feedback-stop", RT::ExecuteId::STOP_FEEDBACK}
+    };
+
+    inline constexpr std::array FOC_REGISTERS = {
+        FocRegister{"motor-id", ST_MPC::RegisterId::TargetMotor, ST_MPC::RegisterType::UInt8},
+        FocRegister{"flags", ST_MPC::RegisterId::Flags, ST_MPC::RegisterType::UInt32},
+        FocRegister{"status", ST_MPC::RegisterId::Status, ST_MPC::RegisterType::UInt8},
+        FocRegister{"control-mode", ST_MPC::RegisterId::ControlMode, ST_MPC::RegisterType::UInt8, Display::ControlMode},
+        FocRegister{"speed-ref", ST_MPC::RegisterId::SpeedRef, ST_MPC::RegisterType::Int32},
+        FocRegister{"speed-Kp", ST_MPC::RegisterId::SpeedKp, ST_MPC::RegisterType::Int16},     // bug in SDK: is Int16
+        FocRegister{"speed-Ki", ST_MPC::RegisterId::SpeedKi, ST_MPC::RegisterType::Int16},     // bug in SDK: is Int16
+        FocRegister{"speed-Kd", ST_MPC::RegisterId::SpeedKd, ST_MPC::RegisterType::Int16},     // bug in SDK: is Int16
+        FocRegister{"torque-ref", ST_MPC::RegisterId::TorqueRef, ST_MPC::RegisterType::Int16},
+        FocRegister{"torque-Kp", ST_MPC::RegisterId::TorqueKp, ST_MPC::RegisterType::Int16},   // bug in SDK: is Int16
+        FocRegister{"torque-Ki", ST_MPC::RegisterId::TorqueKi, ST_MPC::RegisterType::Int16},   // bug in SDK: is Int16
+        FocRegister{"torque-Kd", ST_MPC::RegisterId::TorqueKd, ST_MPC::RegisterType::Int16},   // bug in SDK: is Int16
+        FocRegister{"flux-ref", ST_MPC::RegisterId::FluxRef, ST_MPC::RegisterType::Int16},
+        FocRegister{"flux-Kp", ST_MPC::RegisterId::FluxKp, ST_MPC::RegisterType::Int16},       // bug in SDK: is Int16
+        FocRegister{"flux-Ki", ST_MPC::RegisterId::FluxKi, ST_MPC::RegisterType::Int16},       // bug in SDK: is Int16
+        FocRegister{"flux-Kd", ST_MPC::RegisterId::FluxKd, ST_MPC::RegisterType::Int16},       // bug in SDK: is Int16
+        FocRegister{"motor-power", ST_MPC::RegisterId::MotorPower, ST_MPC::RegisterType::UInt16},
+        FocRegister{"speed-meas", ST_MPC::RegisterId::SpeedMeas, ST_MPC::RegisterType::Int32},
+        FocRegister{"torque-meas", ST_MPC::RegisterId::TorqueMeas, ST_MPC::RegisterType::Int16},
+        FocRegister{"flux-meas", ST_MPC::RegisterId::FluxMeas, ST_MPC::RegisterType::Int16},
+        FocRegister{"Ia", ST_MPC::RegisterId::Ia, ST_MPC::RegisterType::Int16},
+        FocRegister{"Ib", ST_MPC::RegisterId::Ib, ST_MPC::RegisterType::Int16},
+        FocRegister{"Ialpha", ST_MPC::RegisterId::Ialpha, ST_MPC::RegisterType::Int16},
+        FocRegister{"Ibeta", ST_MPC::RegisterId::Ibeta, ST_MPC::RegisterType::Int16},
+        FocRegister{"Iq", ST_MPC::RegisterId::Iq, ST_MPC::RegisterType::Int16},
+        FocRegister{"Id", ST_MPC::RegisterId::Id, ST_MPC::RegisterType::Int16},
+        FocRegister{"Iq-ref", ST_MPC::RegisterId::IqRef, ST_MPC::RegisterType::Int16},
+        FocRegister{"Id-ref", ST_MPC::RegisterId::IdRef, ST_MPC::RegisterType::Int16},
+        FocRegister{"Vq", ST_MPC::RegisterId::Vq, ST_MPC::RegisterType::Int16},
+        FocRegister{"Vd", ST_MPC::RegisterId::Vd, ST_MPC::RegisterType::Int16},
+        FocRegister{"Valpha", ST_MPC::RegisterId::Valpha, ST_MPC::RegisterType::Int16},
+        FocRegister{"Vbeta", ST_MPC::RegisterId::Vbeta, ST_MPC::RegisterType::Int16},
+        FocRegister{"el-angle-meas", ST_MPC::RegisterId::ElAngleMeas, ST_MPC::RegisterType::Int16},
+        FocRegister{"Iq-ref-speed-mode", ST_MPC::RegisterId::IqRefSpeedMode, ST_MPC::RegisterType::Int16},
+        FocRegister{"ramp-final-speed", ST_MPC::RegisterId::RampFinalSpeed, ST_MPC::RegisterType::Int32},
+        FocRegister{"ramp-duration", ST_MPC::RegisterId::RampDuration, ST_MPC::RegisterType::UInt16},
+        FocRegister{"speed-Kp-div", ST_MPC::RegisterId::SpeedKpDiv, ST_MPC::RegisterType::UInt16},
+        FocRegister{"speed-Ki-div", ST_MPC::RegisterId::SpeedKiDiv, ST_MPC::RegisterType::UInt16},
+        FocRegister{"trans-det-1000", ST_MPC::RegisterId::TransDetReg1000, ST_MPC::RegisterType::UInt8},
+        FocRegister{"trans-det-1200", ST_MPC::RegisterId::TransDetReg1200, ST_MPC::RegisterType::UInt8},
+        FocRegister{"trans-det-1300", ST_MPC::RegisterId::TransDetReg1300, ST_MPC::RegisterType::UInt8},
+        FocRegister{"trans-det-Id", ST_MPC::RegisterId::TransDetRegId, ST_MPC::RegisterType::UInt8},
+        FocRegister{"dead-time-Id", ST_MPC::RegisterId::DeadTimeRegId, ST_MPC::RegisterType::UInt8},
+        FocRegister{"dead-time-A", ST_MPC::RegisterId::DeadTimeRegA, ST_MPC::RegisterType::UInt8},
+        FocRegister{"dead-time-B", ST_MPC::RegisterId::DeadTimeRegB, ST_MPC::RegisterType::UInt8},
+        FocRegister{"gdr-pwr-dis", ST_MPC::RegisterId::GdrPwrDis, ST_MPC::RegisterType::UInt8},
+        FocRegister{"gdr-pwm-en", ST_MPC::RegisterId::GdrPwmEn, ST_MPC::RegisterType::UInt8},
+        FocRegister{"gdr-flt-A", ST_MPC::RegisterId::GdrFltPhA, ST_MPC::RegisterType::UInt8},
+        FocRegister{"gdr-flt-B", ST_MPC::RegisterId::GdrFltPhB, ST_MPC::RegisterType::UInt8},
+        FocRegister{"gdr-flt-C", ST_MPC::RegisterId::GdrFltPhC, ST_MPC::RegisterType::UInt8},
+        FocRegister{"gdr-temp-A", ST_MPC::RegisterId::GdrTempPhA, ST_MPC::RegisterType::UInt32, Display::GdrTemperature},
+        FocRegister{"gdr-temp-B", ST_MPC::RegisterId::GdrTempPhB, ST_MPC::RegisterType::UInt32, Display::GdrTemperature},
+        FocRegister{"gdr-temp-C", ST_MPC::RegisterId::GdrTempPhC, ST_MPC::RegisterType::UInt32, Display::GdrTemperature},
+        FocRegister{"mux-Id", ST_MPC::RegisterId::MuxRegId, ST_MPC::RegisterType::UInt8},
+        FocRegister{"torque-Kp-div-pow2", ST_MPC::RegisterId::TorqueKpDivPow2, ST_MPC::RegisterType::UInt16},
+        FocRegister{"torque-Ki-div-pow2", ST_MPC::RegisterId::TorqueKiDivPow2, ST_MPC::RegisterType::UInt16},
+        FocRegister{"flux-Kp-div-pow2", ST_MPC::RegisterId::FluxKpDivPow2, ST_MPC::RegisterType::UInt16},
+        FocRegister{"flux-Ki-div-pow2", ST_MPC::RegisterId::FluxKiDivPow2, ST_MPC::RegisterType::UInt16},
+        FocRegister{"speed-Kp-div-pow2", ST_MPC::RegisterId::SpeedKpDivPow2, ST_MPC::RegisterType::UInt16},
+        FocRegister{"speed-Ki-div-pow2", ST_MPC::RegisterId::SpeedKiDivPow2, ST_MPC::RegisterType::UInt16},
+        FocRegister{"torque-Kp-div", ST_MPC::RegisterId::TorqueKpDiv, ST_MPC::RegisterType::UInt16},
+        FocRegister{"torque-Ki-div", ST_MPC::RegisterId::TorqueKiDiv, ST_MPC::RegisterType::UInt16},
+        FocRegister{"flux-Kp-div", ST_MPC::RegisterId::FluxKpDiv, ST_MPC::RegisterType::UInt16},
+        FocRegister{"flux-Ki-div", ST_MPC::RegisterId::FluxKiDiv, ST_MPC::RegisterType::UInt16},
+        FocRegister{"align-final-flux", ST_MPC::RegisterId::AlignFinalFlux, ST_MPC::RegisterType::UInt16},
+        FocRegister{"align-ramp-up", ST_MPC::RegisterId::AlignRampUpDuration, ST_MPC::RegisterType::UInt16},
+        FocRegister{"align-ramp-down", ST_MPC::RegisterId::AlignRampDownDuration, ST_MPC::RegisterType::UInt16},
+        FocRegister{"is-aligned", ST_MPC::RegisterId::IsAligned, ST_MPC::RegisterType::UInt16},
+        FocRegister{"git-version", ST_MPC::RegisterId::GitVersion, ST_MPC::RegisterType::CharPtr}
+    };
+
+    inline constexpr std::array FOC_EXECUTES = {
+        FocExecute{"start", ST_MPC::ExecuteId::StartMotor},
+        FocExecute{"stop", ST_MPC::ExecuteId::StopMotor},
+        FocExecute{"stop-ramp", ST_MPC::ExecuteId::StopRamp},
+        FocExecute{"reset", ST_MPC::ExecuteId::Reset},
+        FocExecute{"ping", ST_MPC::ExecuteId::Ping},
+        FocExecute{"encoder-align", ST_MPC::ExecuteId::EncoderAlign},
+        FocExecute{"start-stop", ST_MPC::ExecuteId::StartStop},
+        FocExecute{"fault-ack", ST_MPC::ExecuteId::FaultAck}
+    };
+
+    // FNV-1a with the seed mixed into the offset basis
+    constexpr uint32_t hashName(std::string_view name, uint32_t seed)
+    {
+        uint32_t hash = 2166136261u ^ seed;
+        for (char c : name) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+        }
+        return hash;
+    }
+
+    // Collision-free name -> entry index for a fixed table. The slot array is 8x the entry
+    // count, which keeps the compile-time seed search to a handful of tries.
+    template <typename Entry, size_t N>
+    class PerfectHash
+    {
+    public:
+        static_assert(N < 255, "Slot indices are stored as uint8_t");
+
+        constexpr explicit PerfectHash(const std::array<Entry, N>& entries) : table(&entries)
+        {
+            for (uint32_t candidate = 1; candidate < MAX_SEED; ++candidate) {
+                if (build(candidate)) {
+                    seed = candidate;
+                    return;
+                }
+            }
+        }
+
+        // False when no seed separates all names, i.e. a name occurs twice
+        constexpr bool valid() const { return seed != 0; }
+
+        constexpr const Entry* find(std::string_view name) const
+        {
+            uint8_t slot = slots[hashName(name, seed) & (SLOT_COUNT - 1)];
+            if (slot == 0 || (*table)[slot - 1].name != name) {
+                return nullptr;
+            }
+            return &(*table)[slot - 1];
+        }
+
+    private:
+        static constexpr size_t slotCount()
+        {
+            size_t count = 1;
+            while (count < 8 * N) {
+                count <<= 1;
+            }
+            return count;
+        }
+        static constexpr size_t SLOT_COUNT = slotCount();
+        static constexpr uint32_t MAX_SEED = 10000;
+
+        constexpr bool build(uint32_t candidate)
+        {
+            slots = {};
+            for (size_t i = 0; i < N; ++i) {
+                uint8_t& slot = slots[hashName((*table)[i].name, candidate) & (SLOT_COUNT - 1)];
+                if (slot != 0) {
+                    return false;
+                }
+                slot = static_cast<uint8_t>(i + 1);     // 0 marks an empty slot
+            }
+            return true;
+        }
+
+        const std::array<Entry, N>* table;
+        std::array<uint8_t, SLOT_COUNT> slots{};
+        uint32_t seed{0};
+    };
+
+    inline constexpr PerfectHash RT_REGISTER_INDEX{RT_REGISTERS};
+    inline constexpr PerfectHash RT_EXECUTE_INDEX{RT_EXECUTES};
+    inline constexpr PerfectHash FOC_REGISTER_INDEX{FOC_REGISTERS};
+    inline constexpr PerfectHash FOC_EXECUTE_INDEX{FOC_EXECUTES};
+
+    static_assert(RT_REGISTER_INDEX.valid(), "Duplicate RT register name");
+    static_assert(RT_EXECUTE_INDEX.valid(), "Duplicate RT execute name");
+    static_assert(FOC_REGISTER_INDEX.valid(), "Duplicate FOC register name");
+    static_assert(FOC_EXECUTE_INDEX.valid(), "Duplicate FOC execute name");
+
+    // nullptr for unknown names
+    constexpr const RtRegister* findRtRegister(std::string_view name) { return RT_REGISTER_INDEX.find(name); }
+    constexpr const RtExecute* findRtExecute(std::string_view name) { return RT_EXECUTE_INDEX.find(name); }
+    constexpr const FocRegister* findFocRegister(std::string_view name) { return FOC_REGISTER_INDEX.find(name); }
+    constexpr const FocExecute* findFocExecute(std::string_view name) { return FOC_EXECUTE_INDEX.find(name); }
+
+    // FOC values travel in the same little-endian encodings as the RT types
+    constexpr RT::RegisterType toRtType(ST_MPC::RegisterType type)
+    {
+        switch (type) {
+            case ST_MPC::RegisterType::UInt8:  return RT::RegisterType::UInt8;
+            case ST_MPC::RegisterType::Int16:  return RT::RegisterType::Int16;
+            case ST_MPC::RegisterType::UInt16: return RT::RegisterType::UInt16;
+            case ST_MPC::RegisterType::Int32:  return RT::RegisterType::Int32;
+            case ST_MPC::RegisterType::UInt32: return RT::RegisterType::UInt32;
+            default:                           return RT::RegisterType::CharPtr;
+        }
+    }
+
+    constexpr std::string_view typeName(RT::RegisterType type)
+    {
+        switch (type) {
+            case RT::RegisterType::UInt8:   return "UINT8";
+            case RT::RegisterType::Int16:   return "INT16";
+            case RT::RegisterType::UInt16:  return "UINT16";
+            case RT::RegisterType::Int32:   return "INT32";
+            case RT::RegisterType::UInt32:  return "UINT32";
+            case RT::RegisterType::Float:   return "FLOAT";
+            case RT::RegisterType::CharPtr: return "STRING";
+        }
+        return "UNKNOWN";
+    }
+}
+
+#endif // REGISTER_TABLE_RT_H
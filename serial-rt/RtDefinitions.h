@@ -2,9 +2,34 @@
 #define RT_DEFINITIONS_H
 
 #include <cstdint>
+#include <cstddef>
 
 namespace RT 
 {
+    constexpr uint8_t START_BYTE = 0xAA;
+    constexpr uint8_t END_BYTE = 0xAA;
+    constexpr size_t HEADER_SIZE = 16;
+
+    enum class HeaderIndex : uint8_t
+    {
+        StartByte = 0,
+        TotalSize = 1,
+        PayloadSize = 2,
+        MscId = 3,
+        MsgRequestId = 4,
+        MsgResponseId = 5,
+        ConversationId = 6,
+        SenderId = 7,
+        NumBlocks = 8,
+        SeqId = 9,
+        CommandType = 10,
+        ErrorCode = 11,
+        FutureUse0 = 12,
+        FutureUse1 = 13,
+        FutureUse2 = 14,
+        EndByte = 15
+    };
+
     enum class RegisterId : uint8_t 
     {
         RAMP_FINAL_SPEED = 0x01,        // INT32
@@ -39,9 +64,20 @@ namespace RT
         RT_READ = 4,
         RT_READ_REPLY = 5,
         FOC_COMMAND = 6,
-        FOC_COMMAND_REPLY = 7
+        FOC_COMMAND_REPLY = 7,
+        RT_BATCH_READ = 8,
+        RT_BATCH_READ_REPLY = 9
     };
 
+    // Batch read: numBlocks holds the register count, each register is tagged with its source
+    enum class BatchSource : uint8_t
+    {
+        Rt = 0,
+        Foc = 1
+    };
+
+    constexpr size_t MAX_BATCH_REGISTERS = 16;
+
     enum class ExecuteId : uint8_t 
     {
         START_MOTOR = 0x1,
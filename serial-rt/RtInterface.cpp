@@ -1,6 +1,8 @@
 #include "RtInterface.h"
 #include <readline/readline.h>
 #include <readline/history.h>
+#include <chrono>
+#include <iomanip>
 
 RtInterface::RtInterface(const std::string& port, unsigned int baudRate, uint8_t mscId)
     : mscId(mscId)
@@ -19,7 +21,9 @@ RtInterface::~RtInterface()
 void RtInterface::run()
 {
     while (!SignalHandler::shouldExit()) {
-        char* line = readline("rt> ");
+        // Show the target MSC once commands address another one than given on the command line
+        std::string prompt = handler->getMscId() == mscId ? "rt> " : "rt@" + std::to_string(handler->getMscId()) + "> ";
+        char* line = readline(prompt.c_str());
         if (line == nullptr) {
             std::cout << "CTRL+D detected. Exiting..." << std::endl;
             break;
@@ -34,6 +38,86 @@ void RtInterface::run()
     }
 }
 
+size_t RtInterface::runScript(std::istream& input)
+{
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::string> pending;      // Consecutive writes, sent as one pipelined run
+    std::vector<size_t> pendingLines;
+    size_t lineNumber = 0;
+    size_t commands = 0;
+    size_t failures = 0;
+
+    std::string line;
+    while (!SignalHandler::shouldExit() && std::getline(input, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            continue;
+        }
+        line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+        ++commands;
+
+        if (CommandHandlerRt::isPipelinedCommand(line)) {
+            pending.push_back(line);
+            pendingLines.push_back(lineNumber);
+            // Keep collecting only while further lines are already buffered, so writes fed
+            // through a live pipe are not held until the next command arrives
+            if (pending.size() < CommandHandlerRt::PIPELINE_CHUNK && input.rdbuf()->in_avail() > 0) {
+                continue;
+            }
+            failures += runPipelined(pending, pendingLines);
+            pending.clear();
+            pendingLines.clear();
+            continue;
+        }
+
+        // Anything else may depend on the writes before it
+        failures += runPipelined(pending, pendingLines);
+        pending.clear();
+        pendingLines.clear();
+
+        if (line == "exit") {
+            break;
+        }
+        if (line.rfind("help", 0) == 0) {
+            processUserInput(line);
+            continue;
+        }
+        if (!report(lineNumber, handler->processCommand(line))) {
+            ++failures;
+        }
+    }
+    failures += runPipelined(pending, pendingLines);
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started);
+    std::cout << commands << " commands, " << failures << " failed in " << std::fixed << std::setprecision(1)
+              << elapsed.count() << " ms" << std::endl;
+    return failures;
+}
+
+size_t RtInterface::runPipelined(const std::vector<std::string>& commands, const std::vector<size_t>& lines)
+{
+    size_t failures = 0;
+    auto results = handler->processPipelined(commands);
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!report(lines[i], results[i])) {
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+bool RtInterface::report(size_t line, const CommandHandlerRt::CommandResult& result)
+{
+    if (result.success) {
+        std::cout << "line " << line << ": " << result.message << std::endl;
+    } else {
+        std::cerr << "line " << line << ": Error: " << result.message << std::endl;
+    }
+    return result.success;
+}
+
 void RtInterface::setupSignalHandler()
 {
     SignalHandler::reset();
@@ -80,15 +164,23 @@ void RtInterface::printHelp()
     << "\tfoc-read   <reg>                - Read FOC register value\n"
     << "\tfoc-write  <reg>    <val>       - Write FOC register value\n"
     << "\tfoc-exec   <cmd>                - Execute FOC command\n"
+    << "Bus commands:========================================================================\n"
+    << "\tmsc        [id]                 - Show or select the MSC addressed by all following commands\n"
     << "Logging commands:====================================================================\n"
     << "\tlog-start                       - Start logging\n"
     << "\tlog-stop                        - Stop logging\n"
-    << "\tlog-add-rt     <reg>            - Add register to logging\n"
+    << "\tlog-add-rt     <reg> [rate] [change] - Add register to logging (rate: fast|medium|slow, change: only when it changes)\n"
     << "\tlog-remove-rt  <reg>            - Remove register from logging\n"
-    << "\tlog-add-foc    <reg>            - Add FOC register to logging\n"
+    << "\tlog-add-foc    <reg> [rate] [change] - Add FOC register to logging (rate: fast|medium|slow, change: only when it changes)\n"
     << "\tlog-remove-foc <reg>            - Remove FOC register from logging\n"
     << "\tlog-status                      - Show logging status\n"
-    << "\tlog-config   <fname> <interval> - Update logging configuration\n"
+    << "\tlog-config   <fname> <interval> [single|batch] - Update logging configuration (*.rtlog writes binary)\n"
+    << "\tlog-rates    <medium> <slow>    - Read medium/slow registers every N fast ticks\n"
+    << "\tlog-rotate   <MB> [min] [budget-MB]|off - Split the log into segments, delete the oldest beyond the budget\n"
+    << "\tlog-keepalive <s>               - Write on-change registers at least every s seconds (0 = only on change)\n"
+    << "\tlog-capture  <pre> <post> [fault] [<col> rising|falling|either <level>]|off - Write only windows around triggers\n"
+    << "\tlog-trigger                     - Trigger a capture now\n"
+    << "\tlink-dump    <fname> [ms]|off   - Append link statistics as JSON lines every ms (default 1000)\n"
     << "Other commands:======================================================================\n"
     << "\thelp                            - Show this help\n"
     << "\thelp-reg                        - Show all available registers and associated types\n"
@@ -114,8 +206,15 @@ LoggerRt::LogConfig RtInterface::createLogConfig()
     return {
         .filename = "rt_log.csv",
         .sampleInterval = std::chrono::milliseconds(100),
+        .mediumDivider = 10,
+        .slowDivider = 100,
         .bufferSize = 1024,
-        .useTimestamp = true
+        .useTimestamp = true,
+        .pipelineDepth = 4,
+        .batchRead = false,
+        .format = LoggerRt::LogFormat::Csv,
+        .queueCapacity = 4096,
+        .telemetryName = "/rtif-telemetry"
     };
 }
 
@@ -7,6 +7,7 @@
 #include "LoggerRt.h"
 #include <iostream>
 #include <string>
+#include <vector>
 
 class RtInterface
 {
@@ -18,6 +19,8 @@ public:
     RtInterface& operator=(const RtInterface&) = delete;
 
     void run();
+    // Run commands from a script without prompting; returns the number of failed lines
+    size_t runScript(std::istream& input);
 
 private:
     std::unique_ptr<SerialConnectionRt> serial;
@@ -29,6 +32,8 @@ private:
     void cleanup();
     void processUserInput(const std::string& userInput);
     void processCommand(const std::string& command);
+    size_t runPipelined(const std::vector<std::string>& commands, const std::vector<size_t>& lines);
+    static bool report(size_t line, const CommandHandlerRt::CommandResult& result);
     void printHelp();
 
     static LoggerRt::LogConfig createLogConfig();
@@ -1,14 +1,36 @@
 #include "SerialConnectionRt.h"
+#include "RtDefinitions.h"
+#include "FrameBuilderRt.h"
+#include "Checksum.h"
+#include <algorithm>
 #include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 
 SerialConnectionRt::SerialConnectionRt(const std::string& port, unsigned int baud_rate)
-    : serial(io, port) 
+    : serial(io, port), linkStats(baud_rate / 10)     // 8N1: ten bit times per byte
 {
     configurePort(baud_rate);
+    framePool.reserve(FRAME_POOL_SIZE);
+    startReactor();
+    laneThread = std::thread(&SerialConnectionRt::laneLoop, this);
 }
 
 SerialConnectionRt::~SerialConnectionRt() 
 {
+    {
+        std::lock_guard<std::mutex> lock(laneMutex);
+        laneStopping = true;
+    }
+    laneReady.notify_one();
+    if (laneThread.joinable()) {
+        laneThread.join();
+    }
+    stopReactor();
     try {
         if (serial.is_open()) {
             serial.close();
@@ -32,121 +54,570 @@ void SerialConnectionRt::setTimeout(const std::chrono::milliseconds& timeout)
     readTimeout = timeout;
 }
 
-void SerialConnectionRt::sendFrame(const std::vector<uint8_t>& frame) 
+std::vector<std::vector<uint8_t>> SerialConnectionRt::transactPipelined(
+    const std::vector<std::vector<uint8_t>>& frames, size_t depth) 
 {
-    std::lock_guard<std::mutex> lock(serialMutex);
-    try {
-        // Clear any pending data first
-        clearInputBuffer();
-        
-        // Then send the frame
-        boost::asio::write(serial, boost::asio::buffer(frame));
-    } catch (const std::exception& e) {
-        throw ReadError("Error sending frame: " + std::string(e.what()));
-    }
+    std::vector<std::span<const uint8_t>> views(frames.begin(), frames.end());
+    std::vector<std::vector<uint8_t>> replies;
+    transactPipelined(views, replies, depth);
+    return replies;
 }
 
-std::vector<uint8_t> SerialConnectionRt::readFrame() 
+void SerialConnectionRt::transactPipelined(std::span<const std::span<const uint8_t>> frames,
+                                           std::vector<std::vector<uint8_t>>& replies, size_t depth) 
 {
+    replies.resize(frames.size());
+    for (auto& reply : replies) {
+        reply.clear();
+    }
+    if (frames.empty()) {
+        return;
+    }
     std::lock_guard<std::mutex> lock(serialMutex);
+    runPipeline(frames, replies, depth);
+}
+
+void SerialConnectionRt::runPipeline(std::span<const std::span<const uint8_t>> frames,
+                                     std::vector<std::vector<uint8_t>>& replies, size_t depth)
+{
+    depth = std::max<size_t>(depth, 1);
+    discardStaleFrames();
+
+    inFlight.clear();
+    size_t nextToSend = 0;
+    std::vector<uint8_t>& reply = scratchReply;
+
+    // Queued interactive requests take every free slot before the next batch frame
+    auto fill = [&] {
+        while (inFlight.size() < depth) {
+            if (sendInteractive()) {
+                continue;
+            }
+            if (nextToSend == frames.size()) {
+                break;
+            }
+            auto now = std::chrono::steady_clock::now();
+            inFlight.push_back({frames[nextToSend], nextToSend, {}, false, now,
+                                now + replyTimeout(frames[nextToSend]), 0});
+            writeFrame(frames[nextToSend++]);
+        }
+    };
+
     try {
-        // Read header (16 bytes)
-        std::vector<uint8_t> frame = readWithTimeout(16);
-        if (frame.size() != 16) {
-            throw ReadError("Failed to read header");
+        fill();
+        while (!inFlight.empty()) {
+            auto due = std::min_element(inFlight.begin(), inFlight.end(),
+                [](const InFlight& a, const InFlight& b) { return a.deadline < b.deadline; });
+            if (!readFrameUntil(reply, due->deadline)) {
+                recordTimeout(due->frame);
+                if (due->retries < retryLimit(due->frame)) {
+                    linkStats.addRetry();
+                    due->retries++;
+                    due->sent = std::chrono::steady_clock::now();
+                    due->deadline = due->sent + replyTimeout(due->frame);
+                    writeFrame(due->frame);
+                } else {
+                    // Given up: a batch request keeps its empty reply
+                    if (due->isInteractive) {
+                        failInteractive(due->interactive, "Read frame error: Timeout");
+                    }
+                    inFlight.erase(due);
+                    fill();
+                }
+                continue;
+            }
+
+            uint32_t key = transactionKey(reply);
+            auto it = std::find_if(inFlight.begin(), inFlight.end(), [&](const InFlight& request) {
+                return transactionKey(request.frame) == key && isReplyTo(request.frame, reply);
+            });
+            // Ids we sent but no longer wait for mark a duplicate of a resent request. Only
+            // if the MSC did not echo the ids is the link order used: the oldest outstanding
+            // request of the same command is the one being answered.
+            if (it == inFlight.end() && !wasSent(key)) {
+                it = std::find_if(inFlight.begin(), inFlight.end(),
+                    [&](const InFlight& request) { return isReplyTo(request.frame, reply); });
+            }
+            if (it == inFlight.end()) {
+                linkStats.addStaleReply();  // From an earlier exchange
+                continue;
+            }
+            recordRtt(it->frame, it->sent, it->retries > 0);
+            if (it->isInteractive) {
+                completeInteractive(it->interactive, reply);
+            } else {
+                // Swap rather than move so the old reply buffer is recycled on the next read
+                replies[it->index].swap(reply);
+            }
+            inFlight.erase(it);
+            fill();
         }
+    }
+    catch (const std::exception& e) {
+        // Leave unanswered batch requests empty; the caller decides how to report them
+        failInteractive(e.what());
+        std::cerr << "Pipelined transaction aborted: " << e.what() << std::endl;
+    }
+}
+
+std::future<std::vector<uint8_t>> SerialConnectionRt::transactAsync(std::vector<uint8_t> frame)
+{
+    std::future<std::vector<uint8_t>> reply;
+    {
+        std::lock_guard<std::mutex> lock(laneMutex);
+        FrameBuilderRt::stampTransaction(frame, ++interactiveConversationId, 0);
+        interactiveQueue.push_back({std::move(frame), {}, std::chrono::steady_clock::now()});
+        reply = interactiveQueue.back().reply.get_future();
+    }
+    laneReady.notify_one();
+    return reply;
+}
 
-        // Get total size from header
-        size_t totalSize = frame[1];
-        if (totalSize < 16) {
-            throw ReadError("Invalid total size");
+SerialConnectionRt::LaneStats SerialConnectionRt::getInteractiveStats() const
+{
+    std::lock_guard<std::mutex> lock(laneMutex);
+    return laneStats;
+}
+
+// Called with serialMutex held; interactiveSent is only touched by its holder
+bool SerialConnectionRt::sendInteractive()
+{
+    std::list<InteractiveRequest>::iterator request;
+    {
+        std::lock_guard<std::mutex> lock(laneMutex);
+        if (interactiveQueue.empty()) {
+            return false;
         }
+        interactiveSent.splice(interactiveSent.end(), interactiveQueue, interactiveQueue.begin());
+        request = std::prev(interactiveSent.end());
+    }
+    auto now = std::chrono::steady_clock::now();
+    inFlight.push_back({request->frame, 0, request, true, now, now + replyTimeout(request->frame), 0});
+    writeFrame(request->frame);
+    return true;
+}
 
-        // Read remaining bytes if any
-        if (totalSize > 16) {
-            size_t remainingBytes = totalSize - 16;
-            std::vector<uint8_t> remaining = readWithTimeout(remainingBytes);
-            if (remaining.size() != remainingBytes) {
-                throw ReadError("Failed to read complete frame");
+void SerialConnectionRt::completeInteractive(std::list<InteractiveRequest>::iterator request,
+                                             std::vector<uint8_t>& reply)
+{
+    double latency = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - request->queued).count();
+    request->reply.set_value(std::move(reply));
+    interactiveSent.erase(request);
+
+    std::lock_guard<std::mutex> lock(laneMutex);
+    laneStats.completed++;
+    laneStats.meanLatencyUs += (latency - laneStats.meanLatencyUs) / static_cast<double>(laneStats.completed);
+    laneStats.maxLatencyUs = std::max(laneStats.maxLatencyUs, latency);
+}
+
+void SerialConnectionRt::failInteractive(std::list<InteractiveRequest>::iterator request,
+                                         const std::string& reason)
+{
+    request->reply.set_exception(std::make_exception_ptr(ReadError(reason)));
+    interactiveSent.erase(request);
+
+    std::lock_guard<std::mutex> lock(laneMutex);
+    laneStats.failed++;
+}
+
+void SerialConnectionRt::failInteractive(const std::string& reason)
+{
+    for (auto& request : interactiveSent) {
+        request.reply.set_exception(std::make_exception_ptr(ReadError(reason)));
+    }
+    std::lock_guard<std::mutex> lock(laneMutex);
+    laneStats.failed += interactiveSent.size();
+    interactiveSent.clear();
+}
+
+// Serves interactive requests while no batch holds the link
+void SerialConnectionRt::laneLoop()
+{
+    std::vector<std::vector<uint8_t>> noReplies;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(laneMutex);
+            laneReady.wait(lock, [this] { return laneStopping || !interactiveQueue.empty(); });
+            if (laneStopping) {
+                return;
             }
-            frame.insert(frame.end(), remaining.begin(), remaining.end());
         }
+        std::lock_guard<std::mutex> lock(serialMutex);
+        runPipeline({}, noReplies, INTERACTIVE_DEPTH);
+    }
+}
 
-        return frame;
+void SerialConnectionRt::writeFrame(std::span<const uint8_t> frame) 
+{
+    try {
+        boost::asio::write(serial, boost::asio::buffer(frame.data(), frame.size()));
+        linkStats.addTx(frame.size());
+        sentKeys[sentKeyCount++ % sentKeys.size()] = transactionKey(frame);
+    } catch (const std::exception& e) {
+        throw ReadError("Error sending frame: " + std::string(e.what()));
     }
-    catch (const std::exception& e) {
-        boost::system::error_code ec;
-        serial.cancel(ec);
-        throw ReadError(std::string("Read frame error: ") + e.what());
+}
+
+void SerialConnectionRt::recordRtt(std::span<const uint8_t> request, std::chrono::steady_clock::time_point sent,
+                                   bool resent)
+{
+    if (request.size() < RT::HEADER_SIZE) {
+        return;
+    }
+    uint8_t commandId = request[static_cast<size_t>(RT::HeaderIndex::CommandType)];
+    auto elapsed = std::chrono::steady_clock::now() - sent;
+    linkStats.recordRtt(commandId, elapsed);
+
+    size_t type = commandId / 2;
+    if (!resent && type < rto.size()) {
+        rto[type].addSample(std::chrono::duration_cast<std::chrono::microseconds>(elapsed));
+        linkStats.setRto(commandId, rto[type].timeout(readTimeout.load()));
     }
 }
 
-std::vector<uint8_t> SerialConnectionRt::readFrame(size_t size) 
+void SerialConnectionRt::recordTimeout(std::span<const uint8_t> request)
 {
-    std::lock_guard<std::mutex> lock(serialMutex);
-    return readWithTimeout(size);
+    linkStats.addTimeout();
+    if (request.size() < RT::HEADER_SIZE) {
+        return;
+    }
+    uint8_t commandId = request[static_cast<size_t>(RT::HeaderIndex::CommandType)];
+    size_t type = commandId / 2;
+    if (type < rto.size()) {
+        rto[type].backoff = std::min(rto[type].backoff + 1, MAX_BACKOFF);
+        linkStats.setRto(commandId, rto[type].timeout(readTimeout.load()));
+    }
 }
 
-std::vector<uint8_t> SerialConnectionRt::readWithTimeout(size_t size) 
+std::chrono::microseconds SerialConnectionRt::replyTimeout(std::span<const uint8_t> request) const
 {
-    std::vector<uint8_t> buffer(size);
-    
-    // Simple synchronous read with timeout
-    boost::asio::async_read(serial,
-        boost::asio::buffer(buffer),
-        [](const boost::system::error_code&, size_t){});
-        
-    if (!serial.native_handle()) {
-        throw ReadError("Invalid serial handle");
+    size_t type = request.size() < RT::HEADER_SIZE ? rto.size()
+        : request[static_cast<size_t>(RT::HeaderIndex::CommandType)] / 2;
+    if (type >= rto.size()) {
+        return readTimeout.load();
     }
+    return rto[type].timeout(readTimeout.load());
+}
 
-    // Use select to implement timeout
-    fd_set read_fds;
-    FD_ZERO(&read_fds);
-    FD_SET(serial.native_handle(), &read_fds);
+unsigned SerialConnectionRt::retryLimit(std::span<const uint8_t> request)
+{
+    if (request.size() < RT::HEADER_SIZE) {
+        return 0;
+    }
+    switch (static_cast<RT::CommandId>(request[static_cast<size_t>(RT::HeaderIndex::CommandType)])) {
+        case RT::CommandId::RT_READ:
+        case RT::CommandId::RT_BATCH_READ:
+            return READ_RETRIES;
+        case RT::CommandId::RT_WRITE:
+            return WRITE_RETRIES;
+        case RT::CommandId::FOC_COMMAND:
+            break;
+        default:
+            return 0;
+    }
 
-    struct timeval timeout;
-    timeout.tv_sec = 1;
-    timeout.tv_usec = 0;
+    // The FOC start frame carries the ST-MPC command in its 5 LSB
+    if (request.size() <= RT::HEADER_SIZE) {
+        return 0;
+    }
+    switch (static_cast<ST_MPC::CommandId>(request[RT::HEADER_SIZE] & 0x1F)) {
+        case ST_MPC::CommandId::GetRegister:
+        case ST_MPC::CommandId::GetInfo:
+        case ST_MPC::CommandId::GetRevup:
+            return READ_RETRIES;
+        case ST_MPC::CommandId::SetRegister:
+        case ST_MPC::CommandId::SetRevup:
+        case ST_MPC::CommandId::SetCurrentRef:
+            return WRITE_RETRIES;
+        default:
+            return 0;
+    }
+}
 
-    int result = select(serial.native_handle() + 1, &read_fds, nullptr, nullptr, &timeout);
-    if (result < 0) {
-        throw ReadError("Select error");
+void SerialConnectionRt::RtoEstimator::addSample(std::chrono::microseconds rtt)
+{
+    if (!valid) {
+        srtt = rtt;
+        rttvar = rtt / 2;
+        valid = true;
+    } else {
+        auto error = rtt - srtt;
+        rttvar += (std::chrono::abs(error) - rttvar) / 4;
+        srtt += error / 8;
     }
-    if (result == 0) {
-        throw ReadError("Timeout");
+    backoff = 0;
+}
+
+std::chrono::microseconds SerialConnectionRt::RtoEstimator::timeout(std::chrono::microseconds ceiling) const
+{
+    if (!valid) {
+        return ceiling;
     }
+    auto rto = (srtt + std::max(MIN_RTO_VARIANCE, 4 * rttvar)) * (1 << backoff);
+    return std::min(std::max(rto, MIN_RTO), ceiling);
+}
 
-    // Perform the actual read
-    size_t bytesRead = boost::asio::read(serial, boost::asio::buffer(buffer));
-    if (bytesRead != size) {
-        throw ReadError("Incomplete read");
+bool SerialConnectionRt::isReplyTo(std::span<const uint8_t> request, std::span<const uint8_t> reply) 
+{
+    const size_t commandType = static_cast<size_t>(RT::HeaderIndex::CommandType);
+    if (request.size() < RT::HEADER_SIZE || reply.size() < RT::HEADER_SIZE) {
+        return false;
+    }
+    return reply[commandType] == request[commandType] + 1;
+}
+
+// Ids echoed in a reply; the MSC id keeps requests to different MSCs apart
+uint32_t SerialConnectionRt::transactionKey(std::span<const uint8_t> frame) 
+{
+    if (frame.size() < RT::HEADER_SIZE) {
+        return 0;
+    }
+    return static_cast<uint32_t>(frame[static_cast<size_t>(RT::HeaderIndex::MscId)]) << 16 |
+           static_cast<uint32_t>(frame[static_cast<size_t>(RT::HeaderIndex::ConversationId)]) << 8 |
+           frame[static_cast<size_t>(RT::HeaderIndex::SeqId)];
+}
+
+bool SerialConnectionRt::wasSent(uint32_t key) const
+{
+    auto end = sentKeys.begin() + std::min(sentKeyCount, sentKeys.size());
+    return std::find(sentKeys.begin(), end, key) != end;
+}
+
+bool SerialConnectionRt::readFrameUntil(std::vector<uint8_t>& frame, std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lock(rxMutex);
+    if (!rxReady.wait_until(lock, deadline, [this] { return !rxFrames.empty(); })) {
+        return false;
+    }
+
+    // Hand the queued buffer to the caller and keep the caller's old one for reuse
+    frame.swap(rxFrames.front());
+    if (framePool.size() < FRAME_POOL_SIZE && rxFrames.front().capacity() > 0) {
+        framePool.push_back(std::move(rxFrames.front()));
+    }
+    rxFrames.pop_front();
+    return true;
+}
+
+void SerialConnectionRt::startReactor()
+{
+    int fd = serial.native_handle();
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        throw ReadError("Unable to set serial port non-blocking");
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        throw ReadError("Unable to create receive reactor");
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        throw ReadError("Unable to watch serial port");
+    }
+    event.data.fd = wakeFd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) < 0) {
+        throw ReadError("Unable to watch reactor wakeup");
+    }
+
+    reactorThread = std::thread(&SerialConnectionRt::reactorLoop, this);
+}
+
+void SerialConnectionRt::stopReactor()
+{
+    if (wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+    if (reactorThread.joinable()) {
+        reactorThread.join();
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+        epollFd = -1;
+    }
+    if (wakeFd >= 0) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
+}
+
+void SerialConnectionRt::reactorLoop()
+{
+    epoll_event events[2];
+    while (true) {
+        int count = epoll_wait(epollFd, events, 2, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Serial reactor error: " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.fd == wakeFd) {
+                return;
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                std::cerr << "Serial reactor: port closed" << std::endl;
+                return;
+            }
+            drainPort();
+        }
     }
+}
 
-    return buffer;
+void SerialConnectionRt::drainPort()
+{
+    int fd = serial.native_handle();
+    bool framesReady = false;
+    {
+        std::lock_guard<std::mutex> lock(rxMutex);
+        while (true) {
+            auto region = rxRing.writeRegion();
+            if (region.size == 0) {
+                framesReady |= extractFrames();
+                if (rxRing.freeSpace() == 0) {
+                    resync();   // Full of bytes that never formed a frame
+                }
+                continue;
+            }
+            ssize_t n = read(fd, region.data, region.size);
+            if (n > 0) {
+                rxRing.commit(static_cast<size_t>(n));
+                linkStats.addRxBytes(static_cast<size_t>(n));
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            break;  // EAGAIN: port drained
+        }
+        framesReady |= extractFrames();
+    }
+    if (framesReady) {
+        rxReady.notify_one();
+    }
 }
 
-void SerialConnectionRt::clearInputBuffer()
+bool SerialConnectionRt::extractFrames()
 {
-    // Read any pending data with a very short timeout
-    struct timeval shortTimeout;
-    shortTimeout.tv_sec = 0;
-    shortTimeout.tv_usec = 1000;  // 1ms
-    
-    std::vector<uint8_t> buffer(256);
+    bool extracted = false;
     while (true) {
-        fd_set read_fds;
-        FD_ZERO(&read_fds);
-        FD_SET(serial.native_handle(), &read_fds);
-        
-        int result = select(serial.native_handle() + 1, &read_fds, nullptr, nullptr, &shortTimeout);
-        if (result <= 0) {
-            break;  // No more data or error
+        switch (syncState) {
+            case SyncState::SeekStart:
+                while (!rxRing.empty() && rxRing[0] != RT::START_BYTE) {
+                    rxRing.consume(1);
+                }
+                if (rxRing.empty()) {
+                    return extracted;
+                }
+                syncState = SyncState::AwaitHeader;
+                break;
+
+            case SyncState::AwaitHeader:
+                if (rxRing.size() < RT::HEADER_SIZE) {
+                    return extracted;
+                }
+                expectedSize = rxRing[static_cast<size_t>(RT::HeaderIndex::TotalSize)];
+                if (!headerPlausible()) {
+                    resync();
+                    break;
+                }
+                syncState = SyncState::AwaitBody;
+                break;
+
+            case SyncState::AwaitBody: {
+                if (rxRing.size() < expectedSize) {
+                    return extracted;
+                }
+                if (!checksumValid()) {
+                    linkStats.addCrcFailure();
+                    resync();
+                    break;
+                }
+                std::vector<uint8_t> frame = takeFrameBuffer();
+                frame.resize(expectedSize);
+                rxRing.copyOut(frame.data(), expectedSize);
+                rxRing.consume(expectedSize);
+                rxFrames.push_back(std::move(frame));
+                linkStats.addRxFrame();
+                extracted = true;
+                syncState = SyncState::SeekStart;
+                break;
+            }
         }
-        
-        // Read and discard data
-        boost::system::error_code ec;
-        serial.read_some(boost::asio::buffer(buffer), ec);
-        if (ec) break;
     }
-}
\ No newline at end of file
+}
+
+bool SerialConnectionRt::headerPlausible() const
+{
+    if (expectedSize < RT::HEADER_SIZE) {
+        return false;
+    }
+    // Write replies are header-only and carry their CRC in the end byte position
+    if (expectedSize == RT::HEADER_SIZE) {
+        return rxRing[static_cast<size_t>(RT::HeaderIndex::CommandType)] ==
+               static_cast<uint8_t>(RT::CommandId::RT_WRITE_REPLY);
+    }
+    return rxRing[static_cast<size_t>(RT::HeaderIndex::EndByte)] == RT::END_BYTE;
+}
+
+bool SerialConnectionRt::checksumValid() const
+{
+    const size_t commandType = static_cast<size_t>(RT::HeaderIndex::CommandType);
+    // The firmware does not checksum write replies or git version replies
+    // (FrameInterpreterRt accepts both unchecked as well)
+    if (expectedSize == RT::HEADER_SIZE) {
+        return true;
+    }
+    if (rxRing[commandType] == static_cast<uint8_t>(RT::CommandId::RT_READ_REPLY) &&
+        rxRing[RT::HEADER_SIZE] == static_cast<uint8_t>(RT::RegisterId::GIT_VERSION)) {
+        return true;
+    }
+
+    auto regions = rxRing.readRegions(expectedSize - 1);
+    Checksum::Additive crc;
+    crc.add(regions[0].data, regions[0].size).add(regions[1].data, regions[1].size);
+    return Checksum::fold(crc.sum()) == rxRing[expectedSize - 1];
+}
+
+void SerialConnectionRt::resync()
+{
+    // Drop the false start byte and hunt for the next one
+    linkStats.addResync();
+    rxRing.consume(1);
+    syncState = SyncState::SeekStart;
+}
+
+// Late or duplicate replies that arrived after their request was settled
+void SerialConnectionRt::discardStaleFrames()
+{
+    std::lock_guard<std::mutex> lock(rxMutex);
+    while (!rxFrames.empty()) {
+        linkStats.addStaleReply();
+        if (framePool.size() < FRAME_POOL_SIZE) {
+            framePool.push_back(std::move(rxFrames.front()));
+        }
+        rxFrames.pop_front();
+    }
+}
+
+std::vector<uint8_t> SerialConnectionRt::takeFrameBuffer()
+{
+    if (framePool.empty()) {
+        std::vector<uint8_t> frame;
+        frame.reserve(256);
+        return frame;
+    }
+    std::vector<uint8_t> frame = std::move(framePool.back());
+    framePool.pop_back();
+    return frame;
+}
@@ -3,16 +3,26 @@
 
 #include <utility>  // known issue with boost::asio and C++17
 #include <boost/asio.hpp>
+#include "ByteRingBuffer.h"
+#include "LinkStatsRt.h"
+#include <array>
+#include <atomic>
 #include <string>
+#include <span>
 #include <vector>
+#include <deque>
 #include <chrono>
+#include <condition_variable>
+#include <future>
+#include <list>
 #include <mutex>
+#include <thread>
 #include <iomanip>
 
-class SerialConnectionRt 
+class SerialConnectionRt
 {
 public:
-    class ReadError : public std::runtime_error 
+    class ReadError : public std::runtime_error
     {
     public:
         explicit ReadError(const std::string& msg) : std::runtime_error(msg) {}
@@ -21,21 +31,160 @@ public:
     SerialConnectionRt(const std::string& port, unsigned int baud_rate);
     ~SerialConnectionRt();
 
-    void sendFrame(const std::vector<uint8_t>& frame);
-    std::vector<uint8_t> readFrame();
-    std::vector<uint8_t> readFrame(size_t size);
-    
+    // Keep up to 'depth' requests in flight and match replies on mscId/conversationId/seqId;
+    // duplicates of resent requests are dropped as stale. Replies are returned in request
+    // order; an empty entry means no reply was received.
+    std::vector<std::vector<uint8_t>> transactPipelined(const std::vector<std::vector<uint8_t>>& frames,
+                                                        size_t depth);
+    // Same, but reuses the caller's reply buffers so steady-state batches do not allocate
+    void transactPipelined(std::span<const std::span<const uint8_t>> frames,
+                           std::vector<std::vector<uint8_t>>& replies, size_t depth);
+
+    // Interactive lane: queue one request and return its reply asynchronously. A running
+    // pipelined batch sends queued interactive requests at its next send opportunity, ahead
+    // of its own remaining frames, so they wait for at most one frame on the link instead of
+    // a whole logging sweep. The request is stamped with seqId 0, which batches never use,
+    // to tell its reply apart. A failed request completes the future with ReadError.
+    std::future<std::vector<uint8_t>> transactAsync(std::vector<uint8_t> frame);
+
+    // Interactive requests from queueing to reply
+    struct LaneStats
+    {
+        uint64_t completed{0};
+        uint64_t failed{0};
+        double meanLatencyUs{0.0};
+        double maxLatencyUs{0.0};
+    };
+    LaneStats getInteractiveStats() const;
+
+    // Longest wait for a reply; also the timeout before the first round trip has been measured
     void setTimeout(const std::chrono::milliseconds& timeout);
 
+    // Reply timeouts adapt to the measured round-trip time of each command type (see RtoEstimator).
+    // A request that times out is sent again up to its class limit: reads are always safe to
+    // repeat, writes set the same value again, executes are never repeated. A request that runs
+    // out of retries fails on its own; the rest of a pipelined batch carries on.
+    static constexpr unsigned READ_RETRIES = 2;
+    static constexpr unsigned WRITE_RETRIES = 1;
+    static constexpr std::chrono::microseconds MIN_RTO{3000};
+    static constexpr std::chrono::microseconds MIN_RTO_VARIANCE{1000};    // Scheduling granularity
+    static constexpr unsigned MAX_BACKOFF = 6;
+
+    // Byte/frame/error counters and per-command round-trip histograms, always maintained
+    const LinkStatsRt& getLinkStats() const { return linkStats; }
+
 private:
+    // Retransmission timeout from smoothed round-trip times as in TCP (RFC 6298):
+    // srtt + max(MIN_RTO_VARIANCE, 4 * rttvar), doubled per consecutive timeout and clamped to
+    // [MIN_RTO, readTimeout]. Replies to resent requests are not sampled, they are ambiguous.
+    struct RtoEstimator
+    {
+        std::chrono::microseconds srtt{0};
+        std::chrono::microseconds rttvar{0};
+        unsigned backoff{0};
+        bool valid{false};
+
+        void addSample(std::chrono::microseconds rtt);
+        std::chrono::microseconds timeout(std::chrono::microseconds ceiling) const;
+    };
+
+    static constexpr size_t RX_RING_SIZE = 4096;
+    static constexpr size_t FRAME_POOL_SIZE = 16;
+    static constexpr size_t INTERACTIVE_DEPTH = 4;     // In flight when no batch is running
+    static constexpr size_t SENT_KEY_HISTORY = 256;
+
     boost::asio::io_service io;
     boost::asio::serial_port serial;
-    std::chrono::milliseconds readTimeout{1000}; // Default 1 second timeout
-    std::mutex serialMutex;
-    
-    std::vector<uint8_t> readWithTimeout(size_t size);
+    std::atomic<std::chrono::milliseconds> readTimeout{std::chrono::milliseconds(1000)};
+    std::mutex serialMutex;     // Serializes transactions on the link
+    LinkStatsRt linkStats;
+    std::array<RtoEstimator, LinkStatsRt::COMMAND_TYPES> rto;     // Guarded by serialMutex
+
+    // Receive reactor: one thread drains the port into rxRing and queues complete frames
+    int epollFd{-1};
+    int wakeFd{-1};
+    std::thread reactorThread;
+    std::mutex rxMutex;
+    std::condition_variable rxReady;
+    ByteRingBuffer rxRing{RX_RING_SIZE};
+    std::deque<std::vector<uint8_t>> rxFrames;
+    std::vector<std::vector<uint8_t>> framePool;
+    std::vector<uint8_t> scratchReply;
+
+    struct InteractiveRequest
+    {
+        std::vector<uint8_t> frame;
+        std::promise<std::vector<uint8_t>> reply;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    // Requests on the link, in send order; interactive ones point into interactiveSent
+    struct InFlight
+    {
+        std::span<const uint8_t> frame;
+        size_t index;                                   // Batch frame index
+        std::list<InteractiveRequest>::iterator interactive;
+        bool isInteractive;
+        std::chrono::steady_clock::time_point sent;
+        std::chrono::steady_clock::time_point deadline;
+        unsigned retries;
+    };
+    std::vector<InFlight> inFlight;
+
+    // Keys of the last frames written, to tell duplicate replies from ones without echoed ids;
+    // guarded by serialMutex
+    std::array<uint32_t, SENT_KEY_HISTORY> sentKeys{};
+    size_t sentKeyCount{0};
+
+    // Interactive lane; served by whichever thread holds serialMutex, or laneThread when idle
+    mutable std::mutex laneMutex;
+    std::condition_variable laneReady;
+    std::list<InteractiveRequest> interactiveQueue;
+    std::list<InteractiveRequest> interactiveSent;
+    uint8_t interactiveConversationId{0};
+    bool laneStopping{false};
+    std::thread laneThread;
+    LaneStats laneStats;
+
+    // Byte-level frame synchronization over rxRing
+    enum class SyncState
+    {
+        SeekStart,      // Discarding bytes until a start byte
+        AwaitHeader,    // Start byte found, waiting for the 16-byte header
+        AwaitBody       // Header plausible, waiting for totalSize bytes
+    };
+    SyncState syncState{SyncState::SeekStart};
+    size_t expectedSize{0};
+
+    void reactorLoop();
+    void drainPort();
+    bool extractFrames();
+    bool headerPlausible() const;
+    bool checksumValid() const;
+    void resync();
+    void discardStaleFrames();
+    std::vector<uint8_t> takeFrameBuffer();
+
+    void runPipeline(std::span<const std::span<const uint8_t>> frames,
+                     std::vector<std::vector<uint8_t>>& replies, size_t depth);
+    bool sendInteractive();
+    void completeInteractive(std::list<InteractiveRequest>::iterator request, std::vector<uint8_t>& reply);
+    void failInteractive(std::list<InteractiveRequest>::iterator request, const std::string& reason);
+    void failInteractive(const std::string& reason);
+    void laneLoop();
+
+    bool readFrameUntil(std::vector<uint8_t>& frame, std::chrono::steady_clock::time_point deadline);
+    void writeFrame(std::span<const uint8_t> frame);
+    void recordRtt(std::span<const uint8_t> request, std::chrono::steady_clock::time_point sent, bool resent);
+    std::chrono::microseconds replyTimeout(std::span<const uint8_t> request) const;
+    void recordTimeout(std::span<const uint8_t> request);
+    static unsigned retryLimit(std::span<const uint8_t> request);
+    static uint32_t transactionKey(std::span<const uint8_t> frame);
+    bool wasSent(uint32_t key) const;
+    static bool isReplyTo(std::span<const uint8_t> request, std::span<const uint8_t> reply);
     void configurePort(unsigned int baud_rate);
-    void clearInputBuffer();
+    void startReactor();
+    void stopReactor();
 };
 
-#endif // SERIAL_CONNECTION_RT_H
\ No newline at end of file
+#endif // SERIAL_CONNECTION_RT_H
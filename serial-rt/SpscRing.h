@@ -0,0 +1,59 @@
+// SpscRing.h
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+// Lock-free single-producer/single-consumer FIFO of fixed-size records. Storage is
+// allocated once; capacity is rounded up to a power of two. Exactly one thread may
+// push and exactly one other thread may pop.
+template <typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(size_t capacity)
+        : slots(std::bit_ceil(capacity < 2 ? size_t{2} : capacity)), mask(slots.size() - 1)
+    {
+    }
+
+    size_t capacity() const { return slots.size(); }
+    size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+
+    // Producer side; false when the ring is full
+    bool tryPush(const T& item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == slots.size()) {
+            return false;
+        }
+        slots[h & mask] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; the front record stays valid until pop()
+    const T* front() const
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t) {
+            return nullptr;
+        }
+        return &slots[t & mask];
+    }
+
+    void pop()
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head{0};    // Total records pushed
+    alignas(64) std::atomic<size_t> tail{0};    // Total records popped
+};
+
+#endif // SPSC_RING_H
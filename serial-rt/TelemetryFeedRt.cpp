@@ -0,0 +1,113 @@
+// TelemetryFeedRt.cpp
+#include "TelemetryFeedRt.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static_assert(sizeof(TelemetryFeedRt::TelemetryHeader) <= TelemetryFeedRt::HEADER_SIZE);
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+TelemetryFeedRt::~TelemetryFeedRt()
+{
+    close();
+}
+
+void TelemetryFeedRt::open(const std::string& shmName, size_t slotCount)
+{
+    close();
+
+    int fd = shm_open(shmName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw TelemetryError("Unable to create shared memory " + shmName + ": " + std::strerror(errno));
+    }
+    size_t size = HEADER_SIZE + slotCount * sizeof(TelemetrySlot);
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        shm_unlink(shmName.c_str());
+        throw TelemetryError("Unable to size shared memory " + shmName + ": " + std::strerror(errno));
+    }
+    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        shm_unlink(shmName.c_str());
+        throw TelemetryError("Unable to map shared memory " + shmName + ": " + std::strerror(errno));
+    }
+
+    name = shmName;
+    map = address;
+    mappedSize = size;
+    capacity = static_cast<uint32_t>(slotCount);
+    schemaVersion = 0;
+
+    // Every slot starts with an even (idle) sequence
+    header = new (map) TelemetryHeader{};
+    slots = reinterpret_cast<TelemetrySlot*>(static_cast<uint8_t*>(map) + HEADER_SIZE);
+    for (size_t i = 0; i < slotCount; ++i) {
+        new (&slots[i]) TelemetrySlot{};
+    }
+    header->version = VERSION;
+    header->capacity = capacity;
+    header->maxChannels = MAX_CHANNELS;
+    std::memcpy(header->magic, "RTTELEM", 8);   // Written last: readers wait for the magic
+}
+
+void TelemetryFeedRt::close()
+{
+    if (map == nullptr) {
+        return;
+    }
+    // Attached viewers keep their mapping; new ones no longer find the feed
+    munmap(map, mappedSize);
+    shm_unlink(name.c_str());
+    map = nullptr;
+    header = nullptr;
+    slots = nullptr;
+}
+
+void TelemetryFeedRt::setChannels(std::span<const LogColumn> columns, uint32_t version)
+{
+    size_t count = std::min(columns.size(), MAX_CHANNELS);
+    types.resize(count);
+
+    uint32_t seq = header->headerSeq.load(std::memory_order_relaxed);
+    header->headerSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memset(header->names, 0, sizeof(header->names));
+    for (size_t i = 0; i < count; ++i) {
+        std::strncpy(header->names[i], columns[i].name.c_str(), NAME_SIZE - 1);
+        types[i] = columns[i].type;
+    }
+    header->channelCount = static_cast<uint32_t>(count);
+    header->schemaVersion = version;
+
+    header->headerSeq.store(seq + 2, std::memory_order_release);
+    schemaVersion = version;
+}
+
+void TelemetryFeedRt::publish(std::chrono::system_clock::time_point timestamp,
+                              std::span<const LogValue> values, std::span<const uint8_t> present)
+{
+    uint64_t index = header->published.load(std::memory_order_relaxed);
+    TelemetrySlot& slot = slots[index % capacity];
+
+    uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.timestampUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        timestamp.time_since_epoch()).count();
+    slot.schemaVersion = schemaVersion;
+    size_t count = types.size();
+    for (size_t i = 0; i < count; ++i) {
+        slot.values[i] = present[i] ? numericValue(values[i], types[i]) : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    slot.seq.store(seq + 2, std::memory_order_release);
+    header->published.store(index + 1, std::memory_order_release);
+}
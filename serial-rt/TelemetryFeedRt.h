@@ -0,0 +1,85 @@
+// TelemetryFeedRt.h
+#ifndef TELEMETRY_FEED_RT_H
+#define TELEMETRY_FEED_RT_H
+
+#include "LogFileRt.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Live sample feed in POSIX shared memory for viewers such as plot.py.
+//
+// Layout (native byte order, 64-bit):
+//   header at offset 0, TelemetryHeader; channel names change under headerSeq (odd while writing)
+//   slots at HEADER_SIZE, capacity * TelemetrySlot; sample n lives in slot n % capacity and is
+//   guarded by its own sequence number (odd while writing)
+// A reader remembers how many samples it has seen, reads only slots up to `published`, and
+// drops slots whose sequence changed during the copy or whose schemaVersion is not the header's.
+class TelemetryFeedRt
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t MAX_CHANNELS = 64;
+    static constexpr size_t NAME_SIZE = 32;
+    static constexpr size_t HEADER_SIZE = 4096;
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+    class TelemetryError : public std::runtime_error
+    {
+    public:
+        explicit TelemetryError(const std::string& message) : std::runtime_error(message) {}
+    };
+
+    struct TelemetryHeader
+    {
+        char magic[8];                      // "RTTELEM"
+        uint32_t version;
+        uint32_t capacity;
+        uint32_t maxChannels;
+        std::atomic<uint32_t> headerSeq;
+        uint32_t channelCount;
+        uint32_t schemaVersion;
+        std::atomic<uint64_t> published;    // Samples written so far
+        char names[MAX_CHANNELS][NAME_SIZE];
+    };
+
+    struct TelemetrySlot
+    {
+        std::atomic<uint64_t> seq;
+        int64_t timestampUs;
+        uint32_t schemaVersion;
+        uint32_t reserved;
+        double values[MAX_CHANNELS];        // NaN when the channel was not read or is text
+    };
+
+    TelemetryFeedRt() = default;
+    ~TelemetryFeedRt();
+    TelemetryFeedRt(const TelemetryFeedRt&) = delete;
+    TelemetryFeedRt& operator=(const TelemetryFeedRt&) = delete;
+
+    // Creates (or replaces) the shared memory object, e.g. "/rtif-telemetry"
+    void open(const std::string& name, size_t capacity = DEFAULT_CAPACITY);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    void setChannels(std::span<const LogColumn> columns, uint32_t schemaVersion);
+    void publish(std::chrono::system_clock::time_point timestamp,
+                 std::span<const LogValue> values, std::span<const uint8_t> present);
+
+private:
+    std::string name;
+    void* map{nullptr};
+    size_t mappedSize{0};
+    TelemetryHeader* header{nullptr};
+    TelemetrySlot* slots{nullptr};
+    uint32_t capacity{0};
+    uint32_t schemaVersion{0};
+    std::vector<LogColumnType> types;
+};
+
+#endif // TELEMETRY_FEED_RT_H
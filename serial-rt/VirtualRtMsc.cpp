@@ -0,0 +1,315 @@
+#include "VirtualRtMsc.h"
+#include "Checksum.h"
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+namespace {
+
+constexpr size_t HEADER_SIZE = RT::HEADER_SIZE;
+constexpr uint8_t NO_ERROR = static_cast<uint8_t>(RT::ErrorId::NO_ERROR);
+constexpr char BOARD_INFO[] = "virtual-rt-msc";
+constexpr char GIT_VERSION[] = "0000000-virtual";
+
+size_t headerIndex(RT::HeaderIndex index)
+{
+    return static_cast<size_t>(index);
+}
+
+} // namespace
+
+VirtualRtMsc::VirtualRtMsc()
+{
+    rtRegisters[static_cast<uint8_t>(RT::RegisterId::RAMP_FINAL_SPEED)] = {RT::RegisterType::Int32, 0};
+    rtRegisters[static_cast<uint8_t>(RT::RegisterId::RAMP_DURATION)] = {RT::RegisterType::UInt16, 0};
+    rtRegisters[static_cast<uint8_t>(RT::RegisterId::SPEED_SETPOINT)] = {RT::RegisterType::Float, 0};
+    rtRegisters[static_cast<uint8_t>(RT::RegisterId::SPEED_KP)] = {RT::RegisterType::Float, std::bit_cast<uint32_t>(0.1f)};
+    rtRegisters[static_cast<uint8_t>(RT::RegisterId::SPEED_KI)] = {RT::RegisterType::Float, std::bit_cast<uint32_t>(0.01f)};
+    rtRegisters[static_cast<uint8_t>(RT::RegisterId::SPEED_KD)] = {RT::RegisterType::Float, 0};
+    rtRegisters[static_cast<uint8_t>(RT::RegisterId::CURRENT_SPEED)] = {RT::RegisterType::Float, 0};
+    rtRegisters[static_cast<uint8_t>(RT::RegisterId::SPEED_LOOP_PERIOD_MS)] = {RT::RegisterType::UInt32, 1};
+
+    focRegisters[static_cast<uint8_t>(ST_MPC::RegisterId::TargetMotor)] = {RT::RegisterType::UInt8, 1};
+    focRegisters[static_cast<uint8_t>(ST_MPC::RegisterId::Flags)] = {RT::RegisterType::UInt32, 0};
+    focRegisters[static_cast<uint8_t>(ST_MPC::RegisterId::Status)] = {RT::RegisterType::UInt8, 0};
+    focRegisters[static_cast<uint8_t>(ST_MPC::RegisterId::ControlMode)] = {RT::RegisterType::UInt8, 1};
+    focRegisters[static_cast<uint8_t>(ST_MPC::RegisterId::SpeedRef)] = {RT::RegisterType::Int32, 0};
+    focRegisters[static_cast<uint8_t>(ST_MPC::RegisterId::TorqueRef)] = {RT::RegisterType::Int16, 0};
+    focRegisters[static_cast<uint8_t>(ST_MPC::RegisterId::MotorPower)] = {RT::RegisterType::UInt16, 0};
+    focRegisters[static_cast<uint8_t>(ST_MPC::RegisterId::SpeedMeas)] = {RT::RegisterType::Int32, 0};
+    focRegisters[static_cast<uint8_t>(ST_MPC::RegisterId::TorqueMeas)] = {RT::RegisterType::Int16, 0};
+    focRegisters[static_cast<uint8_t>(ST_MPC::RegisterId::FluxMeas)] = {RT::RegisterType::Int16, 0};
+    for (auto id : {ST_MPC::RegisterId::Ia, ST_MPC::RegisterId::Ib, ST_MPC::RegisterId::Ialpha,
+                    ST_MPC::RegisterId::Ibeta, ST_MPC::RegisterId::Iq, ST_MPC::RegisterId::Id,
+                    ST_MPC::RegisterId::IqRef, ST_MPC::RegisterId::IdRef, ST_MPC::RegisterId::Vq,
+                    ST_MPC::RegisterId::Vd, ST_MPC::RegisterId::Valpha, ST_MPC::RegisterId::Vbeta,
+                    ST_MPC::RegisterId::ElAngleMeas}) {
+        focRegisters[static_cast<uint8_t>(id)] = {RT::RegisterType::Int16, 0};
+    }
+    for (auto id : {ST_MPC::RegisterId::GdrTempPhA, ST_MPC::RegisterId::GdrTempPhB, ST_MPC::RegisterId::GdrTempPhC}) {
+        focRegisters[static_cast<uint8_t>(id)] = {RT::RegisterType::UInt32, 5000};
+    }
+    // Controller tuning and gate driver settings, the usual content of a configuration script
+    for (auto id : {ST_MPC::RegisterId::SpeedKp, ST_MPC::RegisterId::SpeedKi, ST_MPC::RegisterId::SpeedKd,
+                    ST_MPC::RegisterId::TorqueKp, ST_MPC::RegisterId::TorqueKi, ST_MPC::RegisterId::TorqueKd,
+                    ST_MPC::RegisterId::FluxKp, ST_MPC::RegisterId::FluxKi, ST_MPC::RegisterId::FluxKd}) {
+        focRegisters[static_cast<uint8_t>(id)] = {RT::RegisterType::Int16, 0};
+    }
+    for (auto id : {ST_MPC::RegisterId::SpeedKpDiv, ST_MPC::RegisterId::SpeedKiDiv,
+                    ST_MPC::RegisterId::TorqueKpDiv, ST_MPC::RegisterId::TorqueKiDiv,
+                    ST_MPC::RegisterId::FluxKpDiv, ST_MPC::RegisterId::FluxKiDiv,
+                    ST_MPC::RegisterId::SpeedKpDivPow2, ST_MPC::RegisterId::SpeedKiDivPow2,
+                    ST_MPC::RegisterId::TorqueKpDivPow2, ST_MPC::RegisterId::TorqueKiDivPow2,
+                    ST_MPC::RegisterId::FluxKpDivPow2, ST_MPC::RegisterId::FluxKiDivPow2}) {
+        focRegisters[static_cast<uint8_t>(id)] = {RT::RegisterType::UInt16, 0};
+    }
+    for (auto id : {ST_MPC::RegisterId::DeadTimeRegId, ST_MPC::RegisterId::DeadTimeRegA,
+                    ST_MPC::RegisterId::DeadTimeRegB}) {
+        focRegisters[static_cast<uint8_t>(id)] = {RT::RegisterType::UInt8, 0};
+    }
+}
+
+std::vector<uint8_t> VirtualRtMsc::processFrame(const std::vector<uint8_t>& frame)
+{
+    if (frame.size() < HEADER_SIZE + 2 || frame[0] != RT::START_BYTE ||
+        frame[headerIndex(RT::HeaderIndex::TotalSize)] != frame.size()) {
+        return {};  // Not a frame; the real MSC stays silent as well
+    }
+    if (calculateCRC(frame.data(), frame.size() - 1) != frame.back()) {
+        return createErrorReply(frame, RT::ErrorId::BAD_CRC);
+    }
+
+    updateMeasurements();
+
+    switch (static_cast<RT::CommandId>(frame[headerIndex(RT::HeaderIndex::CommandType)])) {
+        case RT::CommandId::RT_READ:
+            return handleRead(frame);
+        case RT::CommandId::RT_WRITE:
+            return handleWrite(frame);
+        case RT::CommandId::RT_EXECUTE:
+            return handleExecute(frame);
+        case RT::CommandId::FOC_COMMAND:
+            return handleFoc(frame);
+        case RT::CommandId::RT_BATCH_READ:
+            return handleBatchRead(frame);
+        default:
+            return createErrorReply(frame, RT::ErrorId::UNKNOWN_START_BYTE);
+    }
+}
+
+void VirtualRtMsc::updateMeasurements()
+{
+    ++tick;
+    float phase = static_cast<float>(tick) * 0.05f;
+    float setpoint = std::bit_cast<float>(rtRegisters[static_cast<uint8_t>(RT::RegisterId::SPEED_SETPOINT)].bits);
+    float speed = setpoint + 5.0f * std::sin(phase * 0.1f);
+
+    rtRegisters[static_cast<uint8_t>(RT::RegisterId::CURRENT_SPEED)].bits = std::bit_cast<uint32_t>(speed);
+    focRegisters[static_cast<uint8_t>(ST_MPC::RegisterId::SpeedMeas)].bits = static_cast<uint32_t>(static_cast<int32_t>(speed));
+
+    auto setCurrent = [this](ST_MPC::RegisterId id, float value) {
+        focRegisters[static_cast<uint8_t>(id)].bits = static_cast<uint32_t>(static_cast<int16_t>(value));
+    };
+    setCurrent(ST_MPC::RegisterId::Ia, 1000.0f * std::sin(phase));
+    setCurrent(ST_MPC::RegisterId::Ib, 1000.0f * std::sin(phase - 2.0944f));
+    setCurrent(ST_MPC::RegisterId::Ialpha, 1000.0f * std::sin(phase));
+    setCurrent(ST_MPC::RegisterId::Ibeta, 1000.0f * std::cos(phase));
+    setCurrent(ST_MPC::RegisterId::ElAngleMeas, 32767.0f * std::sin(phase * 0.5f));
+}
+
+std::vector<uint8_t> VirtualRtMsc::handleRead(const std::vector<uint8_t>& frame)
+{
+    uint8_t regId = frame[HEADER_SIZE];
+    std::vector<uint8_t> payload = {regId};
+
+    if (!appendText(payload, regId)) {
+        auto it = rtRegisters.find(regId);
+        if (it == rtRegisters.end()) {
+            return createErrorReply(frame, RT::ErrorId::INVALID_MSC);
+        }
+        appendValue(payload, it->second);
+    }
+    return createReply(frame, RT::CommandId::RT_READ_REPLY, payload);
+}
+
+std::vector<uint8_t> VirtualRtMsc::handleWrite(const std::vector<uint8_t>& frame)
+{
+    uint8_t regId = frame[HEADER_SIZE];
+    auto it = rtRegisters.find(regId);
+    if (it == rtRegisters.end()) {
+        return createErrorReply(frame, RT::ErrorId::INVALID_MSC);
+    }
+
+    size_t width = frame.size() - HEADER_SIZE - 2;     // Minus regId and CRC
+    uint32_t bits = 0;
+    for (size_t i = 0; i < width && i < 4; ++i) {
+        bits |= static_cast<uint32_t>(frame[HEADER_SIZE + 1 + i]) << (8 * i);
+    }
+    it->second.bits = bits;
+    return createWriteReply(frame);
+}
+
+std::vector<uint8_t> VirtualRtMsc::handleExecute(const std::vector<uint8_t>& frame)
+{
+    return createReply(frame, RT::CommandId::RT_EXECUTE_REPLY, {});
+}
+
+std::vector<uint8_t> VirtualRtMsc::handleFoc(const std::vector<uint8_t>& frame)
+{
+    // FOC frame: [startFrame, payloadLength, payload..., focCrc]
+    const uint8_t* foc = frame.data() + HEADER_SIZE;
+    size_t focSize = frame.size() - HEADER_SIZE - 1;
+    if (focSize < 3 || static_cast<size_t>(foc[1]) + 3 != focSize || calculateCRC(foc, focSize - 1) != foc[focSize - 1]) {
+        std::vector<uint8_t> error = {static_cast<uint8_t>(ST_MPC::AckErrorId::BadCrc)};
+        return createReply(frame, RT::CommandId::FOC_COMMAND_REPLY, createFocReply(0xFF, error));
+    }
+
+    auto command = static_cast<ST_MPC::CommandId>(foc[0] & 0x1F);
+    uint8_t mscId = frame[headerIndex(RT::HeaderIndex::MscId)];
+    std::vector<uint8_t> focReply;
+
+    if (command == ST_MPC::CommandId::GetRegister || command == ST_MPC::CommandId::SetRegister) {
+        auto it = focRegisters.find(foc[2]);
+        if (it == focRegisters.end()) {
+            std::vector<uint8_t> error = {static_cast<uint8_t>(ST_MPC::AckErrorId::OutOfRange)};
+            focReply = createFocReply(0xFF, error);
+        } else if (command == ST_MPC::CommandId::GetRegister) {
+            std::vector<uint8_t> data;
+            appendValue(data, it->second);
+            focReply = createFocReply(0xF0, data);
+        } else {
+            uint32_t bits = 0;
+            for (size_t i = 0; i + 1 < foc[1] && i < 4; ++i) {
+                bits |= static_cast<uint32_t>(foc[3 + i]) << (8 * i);
+            }
+            it->second.bits = bits;
+            focReply = createFocReply(0xF0, {});
+        }
+    } else {
+        focReply = createFocReply(0xF0, {});    // Execute and friends are acknowledged only
+    }
+
+    std::vector<uint8_t> payload = {mscId, NO_ERROR};
+    payload.insert(payload.end(), focReply.begin(), focReply.end());
+    return createReply(frame, RT::CommandId::FOC_COMMAND_REPLY, payload);
+}
+
+std::vector<uint8_t> VirtualRtMsc::handleBatchRead(const std::vector<uint8_t>& frame)
+{
+    // Request payload: [count, (source, registerId) * count, CRC]
+    // Reply payload:   [count, (status, length, valueBytes) * count, CRC]
+    uint8_t count = frame[HEADER_SIZE];
+    if (count == 0 || count > RT::MAX_BATCH_REGISTERS || frame.size() != HEADER_SIZE + 1 + 2u * count + 1) {
+        return createErrorReply(frame, RT::ErrorId::INVALID_MSC);
+    }
+
+    std::vector<uint8_t> payload = {count};
+    for (size_t i = 0; i < count; ++i) {
+        auto source = static_cast<RT::BatchSource>(frame[HEADER_SIZE + 1 + 2 * i]);
+        uint8_t regId = frame[HEADER_SIZE + 2 + 2 * i];
+        const auto& table = (source == RT::BatchSource::Foc) ? focRegisters : rtRegisters;
+
+        std::vector<uint8_t> text;
+        if (source == RT::BatchSource::Rt && appendText(text, regId)) {
+            payload.push_back(NO_ERROR);
+            payload.push_back(static_cast<uint8_t>(text.size()));
+            payload.insert(payload.end(), text.begin(), text.end());
+            continue;
+        }
+
+        auto it = table.find(regId);
+        if (it == table.end()) {
+            payload.push_back(source == RT::BatchSource::Foc
+                ? static_cast<uint8_t>(ST_MPC::AckErrorId::OutOfRange)
+                : static_cast<uint8_t>(RT::ErrorId::INVALID_MSC));
+            payload.push_back(0);
+            continue;
+        }
+        payload.push_back(NO_ERROR);
+        payload.push_back(static_cast<uint8_t>(valueWidth(it->second.type)));
+        appendValue(payload, it->second);
+    }
+    return createReply(frame, RT::CommandId::RT_BATCH_READ_REPLY, payload);
+}
+
+std::vector<uint8_t> VirtualRtMsc::createReply(const std::vector<uint8_t>& request, RT::CommandId reply,
+                                               const std::vector<uint8_t>& payload)
+{
+    // Echo the request header so conversationId/seqId match, then patch the reply fields
+    std::vector<uint8_t> response(request.begin(), request.begin() + HEADER_SIZE);
+    response[headerIndex(RT::HeaderIndex::TotalSize)] = static_cast<uint8_t>(HEADER_SIZE + payload.size() + 1);
+    response[headerIndex(RT::HeaderIndex::PayloadSize)] = static_cast<uint8_t>(payload.size() + 1);
+    response[headerIndex(RT::HeaderIndex::CommandType)] = static_cast<uint8_t>(reply);
+    response[headerIndex(RT::HeaderIndex::ErrorCode)] = NO_ERROR;
+    response[headerIndex(RT::HeaderIndex::EndByte)] = RT::END_BYTE;
+    response.insert(response.end(), payload.begin(), payload.end());
+    response.push_back(calculateCRC(response.data(), response.size()));
+    return response;
+}
+
+std::vector<uint8_t> VirtualRtMsc::createErrorReply(const std::vector<uint8_t>& request, RT::ErrorId error)
+{
+    uint8_t command = request[headerIndex(RT::HeaderIndex::CommandType)];
+    auto response = createReply(request, static_cast<RT::CommandId>(command | 0x01), {});
+    response[headerIndex(RT::HeaderIndex::ErrorCode)] = static_cast<uint8_t>(error);
+    response.back() = calculateCRC(response.data(), response.size() - 1);
+    return response;
+}
+
+std::vector<uint8_t> VirtualRtMsc::createWriteReply(const std::vector<uint8_t>& request)
+{
+    // Write replies are header-only with the CRC in the endByte slot
+    std::vector<uint8_t> response(request.begin(), request.begin() + HEADER_SIZE);
+    response[headerIndex(RT::HeaderIndex::TotalSize)] = static_cast<uint8_t>(HEADER_SIZE);
+    response[headerIndex(RT::HeaderIndex::PayloadSize)] = 0;
+    response[headerIndex(RT::HeaderIndex::CommandType)] = static_cast<uint8_t>(RT::CommandId::RT_WRITE_REPLY);
+    response[headerIndex(RT::HeaderIndex::ErrorCode)] = NO_ERROR;
+    response[headerIndex(RT::HeaderIndex::EndByte)] = RT::END_BYTE;
+    response[headerIndex(RT::HeaderIndex::EndByte)] = calculateCRC(response.data(), response.size());
+    return response;
+}
+
+std::vector<uint8_t> VirtualRtMsc::createFocReply(uint8_t ack, const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> reply = {ack, static_cast<uint8_t>(data.size())};
+    reply.insert(reply.end(), data.begin(), data.end());
+    reply.push_back(calculateCRC(reply.data(), reply.size()));
+    return reply;
+}
+
+bool VirtualRtMsc::appendText(std::vector<uint8_t>& out, uint8_t regId)
+{
+    const char* text = nullptr;
+    if (regId == static_cast<uint8_t>(RT::RegisterId::BOARD_INFO)) {
+        text = BOARD_INFO;
+    } else if (regId == static_cast<uint8_t>(RT::RegisterId::GIT_VERSION)) {
+        text = GIT_VERSION;
+    } else {
+        return false;
+    }
+    out.insert(out.end(), text, text + std::strlen(text));
+    return true;
+}
+
+void VirtualRtMsc::appendValue(std::vector<uint8_t>& out, const Register& reg)
+{
+    for (size_t i = 0; i < valueWidth(reg.type); ++i) {
+        out.push_back(static_cast<uint8_t>(reg.bits >> (8 * i)));
+    }
+}
+
+size_t VirtualRtMsc::valueWidth(RT::RegisterType type)
+{
+    switch (type) {
+        case RT::RegisterType::UInt8:   return 1;
+        case RT::RegisterType::Int16:
+        case RT::RegisterType::UInt16:  return 2;
+        default:                        return 4;
+    }
+}
+
+uint8_t VirtualRtMsc::calculateCRC(const uint8_t* data, size_t size)
+{
+    return Checksum::of(data, size);
+}
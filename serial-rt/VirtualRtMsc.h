@@ -0,0 +1,46 @@
+#pragma once
+#include "RtDefinitions.h"
+#include "StMpcDefinitions.h"
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// Host-side stand-in for an RT MSC: answers RT read/write/execute, wrapped FOC
+// commands and batch reads. Measurement registers change on every frame so logs
+// show movement.
+class VirtualRtMsc
+{
+public:
+    VirtualRtMsc();
+    std::vector<uint8_t> processFrame(const std::vector<uint8_t>& frame);
+    // Reply a bus without this MSC would give, e.g. MSC_NOT_PRESENT
+    std::vector<uint8_t> createErrorReply(const std::vector<uint8_t>& request, RT::ErrorId error);
+
+private:
+    struct Register
+    {
+        RT::RegisterType type;
+        uint32_t bits;      // Little-endian value bits, float stored as IEEE-754
+    };
+
+    std::map<uint8_t, Register> rtRegisters;
+    std::map<uint8_t, Register> focRegisters;
+    uint32_t tick{0};
+
+    void updateMeasurements();
+    std::vector<uint8_t> handleRead(const std::vector<uint8_t>& frame);
+    std::vector<uint8_t> handleWrite(const std::vector<uint8_t>& frame);
+    std::vector<uint8_t> handleExecute(const std::vector<uint8_t>& frame);
+    std::vector<uint8_t> handleFoc(const std::vector<uint8_t>& frame);
+    std::vector<uint8_t> handleBatchRead(const std::vector<uint8_t>& frame);
+
+    std::vector<uint8_t> createReply(const std::vector<uint8_t>& request, RT::CommandId reply,
+                                     const std::vector<uint8_t>& payload);
+    std::vector<uint8_t> createWriteReply(const std::vector<uint8_t>& request);
+    std::vector<uint8_t> createFocReply(uint8_t ack, const std::vector<uint8_t>& data);
+
+    static bool appendText(std::vector<uint8_t>& out, uint8_t regId);
+    static void appendValue(std::vector<uint8_t>& out, const Register& reg);
+    static size_t valueWidth(RT::RegisterType type);
+    static uint8_t calculateCRC(const uint8_t* data, size_t size);
+};
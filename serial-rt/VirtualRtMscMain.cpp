@@ -0,0 +1,275 @@
+#include "VirtualRtMsc.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <random>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <signal.h>
+#include <poll.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+volatile sig_atomic_t keep_running = 1;
+
+void signal_handler(int)
+{
+    keep_running = 0;
+}
+
+struct Options
+{
+    bool verbose{false};
+    std::chrono::microseconds latency{0};   // Processing time before a reply starts
+    uint32_t byteRate{0};                   // Line speed in bytes/s, 0 = unlimited
+    uint32_t mscCount{0};                   // MSCs with IDs 1..n, 0 = one MSC answering every ID
+    double dropPercent{0.0};                // Replies lost on the line
+};
+
+// A reply that becomes transmittable at due
+struct PendingReply
+{
+    Clock::time_point due;
+    std::vector<uint8_t> bytes;
+};
+
+struct Stats
+{
+    uint64_t frames{0};
+    uint64_t bytesIn{0};
+    uint64_t bytesOut{0};
+    uint64_t dropped{0};
+};
+
+void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [-v] [-l latency-us] [-b bytes-per-second] [-m msc-count] [-d percent]\n"
+              << "  -v  print every reply\n"
+              << "  -l  delay before each reply is sent (default 0)\n"
+              << "  -m  simulate MSCs 1..n, each processing one request at a time; other IDs get\n"
+              << "      MSC_NOT_PRESENT (default: one MSC that answers every ID)\n"
+              << "  -b  pace both directions to this line rate, e.g. 11520 for 115200 baud 8N1 (default unlimited)\n"
+              << "  -d  drop this share of replies at random, as a lossy line would (default 0)\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "vl:b:m:d:h")) != -1) {
+        switch (opt) {
+            case 'v':
+                options.verbose = true;
+                break;
+            case 'l':
+                options.latency = std::chrono::microseconds(std::strtoul(optarg, nullptr, 10));
+                break;
+            case 'b':
+                options.byteRate = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+            case 'm':
+                options.mscCount = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                if (options.mscCount > 255) {
+                    std::cerr << "At most 255 MSCs" << std::endl;
+                    return false;
+                }
+                break;
+            case 'd':
+                options.dropPercent = std::strtod(optarg, nullptr);
+                break;
+            default:
+                printUsage(argv[0]);
+                return false;
+        }
+    }
+    return true;
+}
+
+int openPseudoTerminal(std::string& slaveName)
+{
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+        std::cerr << "Failed to create pseudo terminal: " << std::strerror(errno) << std::endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+
+    // Raw mode on the slave side, otherwise the line discipline mangles binary frames
+    slaveName = ptsname(fd);
+    int slave = open(slaveName.c_str(), O_RDWR | O_NOCTTY);
+    if (slave >= 0) {
+        struct termios tty;
+        if (tcgetattr(slave, &tty) == 0) {
+            cfmakeraw(&tty);
+            tcsetattr(slave, TCSANOW, &tty);
+        }
+        close(slave);
+    }
+    return fd;
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    std::string slaveName;
+    int fd = openPseudoTerminal(slaveName);
+    if (fd < 0) {
+        return 1;
+    }
+
+    std::cout << "Virtual RT MSC listening on " << slaveName << std::endl;
+    std::cout << "Connect with: ./rtIf " << slaveName << " <msc-id>" << std::endl;
+    if (options.latency.count() > 0 || options.byteRate > 0) {
+        std::cout << "Reply latency " << options.latency.count() << " us, line rate "
+                  << (options.byteRate ? std::to_string(options.byteRate) + " bytes/s" : "unlimited") << std::endl;
+    }
+    if (options.mscCount > 0) {
+        std::cout << "MSC IDs 1.." << options.mscCount << " present" << std::endl;
+    }
+    if (options.dropPercent > 0.0) {
+        std::cout << "Dropping " << options.dropPercent << "% of replies" << std::endl;
+    }
+
+    // Time one byte occupies the line; requests arrive and replies leave no faster than that
+    const Clock::duration byteTime = options.byteRate
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(1000000000ull / options.byteRate))
+        : Clock::duration::zero();
+
+    // Each MSC has its own registers and works on one request at a time, so with -m
+    // a reply waits for the previous request to the same MSC but not for other MSCs
+    std::map<uint8_t, VirtualRtMsc> mscs;
+    std::map<uint8_t, Clock::time_point> mscBusyUntil;
+    Stats stats;
+    std::vector<uint8_t> rx;
+    std::deque<PendingReply> pending;
+    std::vector<uint8_t> tx;            // Released reply bytes not yet on the line
+    Clock::time_point rxFree = Clock::now();
+    Clock::time_point txFree = Clock::now();
+    uint8_t buffer[256];
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> percent(0.0, 100.0);
+    auto started = Clock::now();
+
+    while (keep_running) {
+        auto now = Clock::now();
+
+        // Release replies whose processing time is over, then put as many bytes on the line as it carries
+        while (!pending.empty() && pending.front().due <= now) {
+            if (tx.empty()) {
+                txFree = std::max(txFree, now);
+            }
+            tx.insert(tx.end(), pending.front().bytes.begin(), pending.front().bytes.end());
+            pending.pop_front();
+        }
+        if (!tx.empty() && txFree <= now) {
+            size_t count = tx.size();
+            if (byteTime.count() > 0) {
+                count = std::min<size_t>(count, static_cast<size_t>((now - txFree) / byteTime) + 1);
+            }
+            ssize_t written = write(fd, tx.data(), count);
+            if (written > 0) {
+                tx.erase(tx.begin(), tx.begin() + written);
+                txFree += byteTime * written;
+                stats.bytesOut += static_cast<uint64_t>(written);
+            }
+        }
+
+        // Sleep until input or the next reply/byte is due
+        auto wake = now + std::chrono::milliseconds(100);
+        if (!pending.empty()) {
+            wake = std::min(wake, pending.front().due);
+        }
+        if (!tx.empty()) {
+            wake = std::min(wake, std::max(txFree, now));
+        }
+        auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(wake - now);
+        timespec ts{static_cast<time_t>(timeout.count() / 1000000000), static_cast<long>(timeout.count() % 1000000000)};
+
+        pollfd pfd = {fd, POLLIN, 0};
+        if (ppoll(&pfd, 1, &ts, nullptr) <= 0) {
+            continue;
+        }
+        if (!(pfd.revents & POLLIN)) {
+            // POLLHUP until a client opens the slave side
+            usleep(50000);
+            continue;
+        }
+        ssize_t bytesRead = read(fd, buffer, sizeof(buffer));
+        if (bytesRead <= 0) {
+            continue;
+        }
+        rx.insert(rx.end(), buffer, buffer + bytesRead);
+        stats.bytesIn += static_cast<uint64_t>(bytesRead);
+
+        // Split the byte stream into frames on startByte/totalSize
+        while (rx.size() >= 2) {
+            if (rx[0] != RT::START_BYTE || rx[1] < RT::HEADER_SIZE) {
+                rx.erase(rx.begin());
+                continue;
+            }
+            if (rx.size() < rx[1]) {
+                break;
+            }
+            std::vector<uint8_t> frame(rx.begin(), rx.begin() + rx[1]);
+            rx.erase(rx.begin(), rx.begin() + rx[1]);
+
+            uint8_t id = frame[static_cast<size_t>(RT::HeaderIndex::MscId)];
+            bool present = options.mscCount == 0 || (id >= 1 && id <= options.mscCount);
+            if (options.mscCount == 0) {
+                id = 0;
+            }
+            std::vector<uint8_t> response = present
+                ? mscs[id].processFrame(frame)
+                : mscs[0].createErrorReply(frame, RT::ErrorId::MSC_NOT_PRESENT);
+            stats.frames++;
+            if (options.verbose) {
+                for (auto byte : response) {
+                    std::cout << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte) << " ";
+                }
+                std::cout << std::dec << std::endl;
+            }
+            if (response.empty()) {
+                continue;
+            }
+
+            // The request itself needed frame.size() byte times on the line before processing starts
+            rxFree = std::max(rxFree, Clock::now()) + byteTime * frame.size();
+            auto due = rxFree + options.latency;
+            if (options.mscCount > 0 && present) {
+                auto& busy = mscBusyUntil[id];
+                due = std::max(rxFree, busy) + options.latency;
+                busy = due;
+            }
+            // A lost reply still kept the MSC busy
+            if (percent(random) < options.dropPercent) {
+                stats.dropped++;
+                continue;
+            }
+            auto position = std::find_if(pending.begin(), pending.end(),
+                [due](const PendingReply& reply) { return reply.due > due; });
+            pending.insert(position, {due, std::move(response)});
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+    std::cout << "Shutting down..." << std::endl;
+    std::cout << stats.frames << " frames, " << stats.bytesIn << " bytes in, " << stats.bytesOut
+              << " bytes out, " << stats.dropped << " replies dropped in " << std::fixed << std::setprecision(1) << seconds << " s ("
+              << (seconds > 0 ? stats.frames / seconds : 0.0) << " frames/s)" << std::endl;
+    close(fd);
+    return 0;
+}
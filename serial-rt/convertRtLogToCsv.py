@@ -0,0 +1,100 @@
+import struct
+import sys
+import csv
+
+# Column type codes of LogColumnType and their struct formats; None marks strings
+TYPE_FORMATS = {1: '<B', 2: '<h', 3: '<H', 4: '<i', 5: '<I', 6: '<f', 7: None}
+
+def read_schema(payload, version):
+    count = struct.unpack_from('<H', payload, 0)[0]
+    offset = 2
+    columns = []
+    for _ in range(count):
+        if version == 1:
+            # Version 1 stored floats as int32 * scale
+            col_type, rate, scale, name_length = struct.unpack_from('<BBiB', payload, offset)
+            offset += 7
+        else:
+            col_type, rate, name_length = struct.unpack_from('<BBB', payload, offset)
+            scale = 1
+            offset += 3
+        name = payload[offset:offset + name_length].decode('ascii')
+        offset += name_length
+        columns.append((name, TYPE_FORMATS[col_type], scale))
+    return columns
+
+def float_text(value):
+    # Shortest decimal that reads back to the same 32-bit float, like the CSV log
+    for digits in range(1, 10):
+        text = f"{value:.{digits}g}"
+        if struct.pack('<f', float(text)) == struct.pack('<f', value):
+            return text
+    return repr(value)
+
+def read_sample(payload, columns):
+    timestamp = struct.unpack_from('<q', payload, 0)[0]
+    bitmap_size = (len(columns) + 7) // 8
+    bitmap = payload[8:8 + bitmap_size]
+    offset = 8 + bitmap_size
+
+    row = [timestamp]
+    for i, (_, fmt, scale) in enumerate(columns):
+        if not bitmap[i // 8] & (1 << (i % 8)):
+            row.append('')
+            continue
+        if fmt is None:
+            length = payload[offset]
+            row.append(payload[offset + 1:offset + 1 + length].decode('ascii', errors='replace'))
+            offset += 1 + length
+            continue
+        value = struct.unpack_from(fmt, payload, offset)[0]
+        offset += struct.calcsize(fmt)
+        if scale != 1:
+            row.append(f"{value / scale:.3f}")
+        elif fmt == '<f':
+            row.append(float_text(value))
+        else:
+            row.append(value)
+    return row
+
+def convert_rtlog_to_csv(input_file, output_file):
+    with open(input_file, 'rb') as bin_file, open(output_file, 'w', newline='') as csv_file:
+        csv_writer = csv.writer(csv_file)
+
+        magic = bin_file.read(6)
+        if magic != b'RTLOG\0':
+            print("Not an RT log file")
+            return
+        version = struct.unpack('<H', bin_file.read(2))[0]
+        if version not in (1, 2):
+            print(f"Unsupported RT log version {version}")
+            return
+
+        columns = []
+        while True:
+            record_header = bin_file.read(5)
+            if len(record_header) < 5:
+                break  # End of file
+            kind, length = struct.unpack('<BI', record_header)
+            payload = bin_file.read(length)
+            if len(payload) < length:
+                print("Unexpected end of file")
+                return
+
+            if kind == ord('S'):
+                # Every schema record starts a new header, like the CSV log after a register change
+                columns = read_schema(payload, version)
+                csv_writer.writerow(['Timestamp'] + [name for name, _, _ in columns])
+            elif kind == ord('D'):
+                csv_writer.writerow(read_sample(payload, columns))
+
+    print(f"Conversion complete. CSV file saved as {output_file}")
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print("Usage: python convertRtLogToCsv.py <input_rtlog_file> <output_csv_file>")
+        sys.exit(1)
+
+    input_file = sys.argv[1]
+    output_file = sys.argv[2]
+    convert_rtlog_to_csv(input_file, output_file)
@@ -1,17 +1,38 @@
 #include "RtInterface.h"
+#include <fstream>
 #include <iostream>
 
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <serial-port> <msc-id>\n";
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <serial-port> <msc-id> [script-file|-]\n";
         return 1;
     }
 
+    // Script mode: '-' reads commands from stdin. Unsynced, std::cin reads the descriptor
+    // through its own buffer, which reports how much input is waiting (see runScript)
+    bool fromStdin = argc == 4 && std::string(argv[3]) == "-";
+    if (fromStdin) {
+        std::ios::sync_with_stdio(false);
+    }
+
     try {
         uint8_t mscId = static_cast<uint8_t>(std::stoi(argv[2]));
         RtInterface interface(argv[1], 115200, mscId);
-        interface.run();
-        return 0;
+        if (argc == 3) {
+            interface.run();
+            return 0;
+        }
+
+        std::string script = argv[3];
+        if (fromStdin) {
+            return interface.runScript(std::cin) == 0 ? 0 : 1;
+        }
+        std::ifstream file(script);
+        if (!file) {
+            std::cerr << "Error: cannot open script " << script << std::endl;
+            return 1;
+        }
+        return interface.runScript(file) == 0 ? 0 : 1;
     }
     catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
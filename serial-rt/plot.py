@@ -1,39 +1,104 @@
 import sys
-import pandas as pd
+import mmap
+import math
+import struct
+import time
+from collections import deque
+import numpy as np
 import matplotlib.pyplot as plt
 import matplotlib.animation as animation
 
+# Layout of TelemetryFeedRt (see TelemetryFeedRt.h)
+HEADER_SIZE = 4096
+HEADER = struct.Struct('<8sIIIIIIQ')
+NAME_SIZE = 32
+NAMES_OFFSET = 40
+SLOT_PREFIX = struct.Struct('<QqII')
+
+class TelemetryFeed:
+    def __init__(self, name):
+        path = '/dev/shm/' + name.lstrip('/')
+        while True:
+            try:
+                with open(path, 'rb') as f:
+                    self.map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+                if self.map[:8] == b'RTTELEM\0':
+                    break
+                self.map.close()
+            except (FileNotFoundError, ValueError):
+                pass
+            time.sleep(0.1)
+
+        _, version, self.capacity, self.max_channels, _, _, _, _ = HEADER.unpack_from(self.map, 0)
+        self.slot = struct.Struct(f'<QqII{self.max_channels}d')
+        self.seen = 0
+        self.header_seq = -1
+        self.schema = -1
+        self.names = []
+
+    def read_header(self):
+        while True:
+            _, _, _, _, seq, count, schema, _ = HEADER.unpack_from(self.map, 0)
+            if seq & 1:
+                continue
+            names = []
+            for i in range(count):
+                raw = self.map[NAMES_OFFSET + i * NAME_SIZE:NAMES_OFFSET + (i + 1) * NAME_SIZE]
+                names.append(raw.split(b'\0', 1)[0].decode('ascii'))
+            if HEADER.unpack_from(self.map, 0)[4] == seq:
+                self.header_seq, self.schema, self.names = seq, schema, names
+                return
+
+    def poll(self):
+        """Samples published since the last call, as (timestamp_us, {name: value})."""
+        if HEADER.unpack_from(self.map, 0)[4] != self.header_seq:
+            self.read_header()
+        published = HEADER.unpack_from(self.map, 0)[7]
+        first = max(self.seen, published - self.capacity)
+        samples = []
+        for n in range(first, published):
+            offset = HEADER_SIZE + (n % self.capacity) * self.slot.size
+            fields = self.slot.unpack_from(self.map, offset)
+            seq, timestamp, schema = fields[0], fields[1], fields[2]
+            if seq & 1 or schema != self.schema or SLOT_PREFIX.unpack_from(self.map, offset)[0] != seq:
+                continue  # Being overwritten, or written with other channels
+            values = fields[4:4 + len(self.names)]
+            samples.append((timestamp, dict(zip(self.names, values))))
+        self.seen = published
+        return samples
+
 fig, (ax1,ax2,ax3) = plt.subplots(3, 1, sharex = True)
 sx = 200
+channels = ['rt-speed-meas', 'rt-speed-ref', 'torque-meas', 'torque-ref', 'flux-meas', 'flux-ref']
+history = {name: deque(maxlen=sx) for name in ['Timestamp'] + channels}
+feed = None
+
 def animateFunc(i):
-        
-    df = pd.read_csv(sys.argv[1], sep = ',', index_col=False)
-    t = df.Timestamp.to_numpy()
+    for timestamp, values in feed.poll():
+        history['Timestamp'].append(timestamp)
+        for name in channels:
+            history[name].append(values.get(name, math.nan))
+    if not history['Timestamp']:
+        return
+
+    t = np.array(history['Timestamp'])
     t = (t - t[0])/1e6
-    try:
-        speed = df['rt-speed-meas'].to_numpy()
-        speedRef = df['rt-speed-ref'].to_numpy()
-        torque = df['torque-meas'].to_numpy()
-        torqueRef = df['torque-ref'].to_numpy()
-        flux = df['flux-meas'].to_numpy()
-        fluxRef = df['flux-ref'].to_numpy()
-        ax1.clear()
-        ax2.clear()
-        ax3.clear()
-        ax1.set_ylim([-2000, 2000])
-        ax2.set_ylim([-25000, 25000])
-        ax3.set_ylim([-1000, 25000])
-        ax1.plot(t[-sx:], speed[-sx:], '-o', ms = 2)
-        ax1.plot(t[-sx:], speedRef[-sx:], '-o', ms = 2)
-        ax2.plot(t[-sx:], torque[-sx:], '-o', ms = 2)
-        ax2.plot(t[-sx:], torqueRef[-sx:], '-o', ms = 2)
-        ax3.plot(t[-sx:], flux[-sx:], '-o', ms = 2)
-        ax3.plot(t[-sx:], fluxRef[-sx:], '-o', ms = 2)
-    except Exception as e:
-        print(f"There is no {e}")
+    ax1.clear()
+    ax2.clear()
+    ax3.clear()
+    ax1.set_ylim([-2000, 2000])
+    ax2.set_ylim([-25000, 25000])
+    ax3.set_ylim([-1000, 25000])
+    ax1.plot(t, history['rt-speed-meas'], '-o', ms = 2)
+    ax1.plot(t, history['rt-speed-ref'], '-o', ms = 2)
+    ax2.plot(t, history['torque-meas'], '-o', ms = 2)
+    ax2.plot(t, history['torque-ref'], '-o', ms = 2)
+    ax3.plot(t, history['flux-meas'], '-o', ms = 2)
+    ax3.plot(t, history['flux-ref'], '-o', ms = 2)
 
 if __name__ == '__main__':
     try:
+        feed = TelemetryFeed(sys.argv[1] if len(sys.argv) > 1 else '/rtif-telemetry')
         ani = animation.FuncAnimation(fig, animateFunc, interval=10)
         plt.show()
     except Exception as e:
@@ -41,4 +106,4 @@ if __name__ == '__main__':
     except KeyboardInterrupt:
         print("Interrupted")
         plt.close()
-        pass
\ No newline at end of file
+        pass
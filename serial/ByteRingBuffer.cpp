@@ -0,0 +1,39 @@
+#include "ByteRingBuffer.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+ByteRingBuffer::ByteRingBuffer(size_t capacity)
+{
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        throw std::invalid_argument("Ring buffer capacity must be a power of two");
+    }
+    buffer.resize(capacity);
+    mask = capacity - 1;
+}
+
+ByteRingBuffer::Region ByteRingBuffer::writeRegion()
+{
+    size_t offset = head & mask;
+    size_t contiguous = std::min(freeSpace(), capacity() - offset);
+    return {buffer.data() + offset, contiguous};
+}
+
+void ByteRingBuffer::commit(size_t count)
+{
+    head += std::min(count, freeSpace());
+}
+
+void ByteRingBuffer::copyOut(uint8_t* dest, size_t count) const
+{
+    count = std::min(count, size());
+    size_t offset = tail & mask;
+    size_t first = std::min(count, capacity() - offset);
+    std::memcpy(dest, buffer.data() + offset, first);
+    std::memcpy(dest + first, buffer.data(), count - first);
+}
+
+void ByteRingBuffer::consume(size_t count)
+{
+    tail += std::min(count, size());
+}
@@ -1,5 +1,6 @@
 #include "CommandHandler.h"
 #include <iostream>
+#include <iomanip>
 #include <sstream>
 #include "Logger.h"
 
@@ -481,16 +482,14 @@ const CommandHandler::Register& CommandHandler::getRegister(const std::string& r
 
 std::string CommandHandler::sendAndProcessResponse(const std::vector<uint8_t>& frame) 
 {
-    connection.sendFrame(frame);
-    auto response = connection.readFrame();
+    auto response = connection.transaction(frame);
     frameInterpreter.printResponse(response);
     return frameInterpreter.interpretResponse(response);
 }
 
 std::string CommandHandler::sendAndProcessResponse(const std::vector<uint8_t>& frame, ST_MPC::RegisterType type)
 {
-    connection.sendFrame(frame);
-    auto response = connection.readFrame();
+    auto response = connection.transaction(frame);
     frameInterpreter.printResponse(response);
     return frameInterpreter.interpretResponse(response, type);
 
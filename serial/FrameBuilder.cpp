@@ -1,21 +1,13 @@
 #include "FrameBuilder.h"
+#include "Checksum.h"
 #include <sstream>
 
 std::vector<uint8_t> FrameBuilder::FrameData::complete() 
 {
-    frame.push_back(calculateCRC());
+    frame.push_back(Checksum::of(frame));
     return frame;
 }
 
-uint8_t FrameBuilder::FrameData::calculateCRC() const 
-{
-    uint16_t sum = 0;
-    for (const auto& byte : frame) {
-        sum += byte;
-    }
-    return static_cast<uint8_t>((sum & 0xFF) + (sum >> 8));
-}
-
 void FrameBuilder::validateValue(int32_t value, ST_MPC::RegisterType type) 
 {
     switch (type) {
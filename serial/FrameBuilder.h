@@ -63,7 +63,6 @@ private:
 
     private:
         std::vector<uint8_t> frame;
-        uint8_t calculateCRC() const;
     };
 
     std::vector<uint8_t> valueToBytes(int32_t value, ST_MPC::RegisterType type);
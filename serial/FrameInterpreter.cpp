@@ -1,4 +1,5 @@
 #include "FrameInterpreter.h"
+#include "Checksum.h"
 #include <sstream>
 #include <iomanip>
 #include <iostream>
@@ -70,15 +71,7 @@ FrameInterpreter::ResponseInfo FrameInterpreter::parseResponse(const std::vector
 
 bool FrameInterpreter::validateCRC(const std::vector<uint8_t>& frame) 
 {
-    if (frame.empty()) return false;
-    
-    uint16_t sum = 0;
-    for (size_t i = 0; i < frame.size() - 1; ++i) {
-        sum += frame[i];
-    }
-    
-    uint8_t calculated_crc = static_cast<uint8_t>((sum & 0xFF) + (sum >> 8));
-    return calculated_crc == frame.back();
+    return Checksum::verify(frame);
 }
 
 std::string FrameInterpreter::interpretSuccessResponse(const ResponseInfo& info)
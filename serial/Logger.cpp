@@ -1,5 +1,6 @@
 #include "Logger.h"
 #include "FrameBuilder.h"
+#include <charconv>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -68,6 +69,7 @@ bool Logger::removeRegister(const std::string& regName)
     }
 
     registers.erase(it);
+    registersVersion++;
     
     // If logging is active, rewrite the header
     if (running.load()) {
@@ -91,6 +93,7 @@ bool Logger::addRegister(const std::string& regName, ST_MPC::RegisterId regId, S
 
     RegisterInfo info{regId, type, regName};
     registers.push_back(info);
+    registersVersion++;
     
     // If logging is active, rewrite the header
     if (running.load()) {
@@ -125,65 +128,109 @@ std::vector<std::string> Logger::getLoggedRegisters() const
     return names;
 }
 
-int32_t Logger::extractValue(const std::vector<uint8_t>& response, ST_MPC::RegisterType type)
+namespace
+{
+    bool decodeUInt8(const uint8_t* payload, size_t, int32_t& value)
+    {
+        value = payload[0];
+        return true;
+    }
+
+    bool decodeInt16(const uint8_t* payload, size_t, int32_t& value)
+    {
+        value = static_cast<int16_t>(payload[0] | (payload[1] << 8));
+        return true;
+    }
+
+    bool decodeUInt16(const uint8_t* payload, size_t, int32_t& value)
+    {
+        value = static_cast<uint16_t>(payload[0] | (payload[1] << 8));
+        return true;
+    }
+
+    bool decodeInt32(const uint8_t* payload, size_t, int32_t& value)
+    {
+        value = static_cast<int32_t>(payload[0] | (payload[1] << 8) | (payload[2] << 16) |
+                                     (static_cast<uint32_t>(payload[3]) << 24));
+        return true;
+    }
+
+    // Text registers log only when they hold a number
+    bool decodeText(const uint8_t* payload, size_t length, int32_t& value)
+    {
+        auto text = reinterpret_cast<const char*>(payload);
+        return std::from_chars(text, text + length, value).ec == std::errc();
+    }
+}
+
+// UInt32 is logged through int32_t as before, so it shares the Int32 decoder
+Logger::DecodeFn Logger::decoderFor(ST_MPC::RegisterType type, size_t& minLength)
 {
     switch (type) {
-        case ST_MPC::RegisterType::UInt8:
-            return response[2];
-        case ST_MPC::RegisterType::Int16:
-            return static_cast<int16_t>(response[2] | (response[3] << 8));
-        case ST_MPC::RegisterType::UInt16:
-            return static_cast<uint16_t>(response[2] | (response[3] << 8));
+        case ST_MPC::RegisterType::UInt8:   minLength = 1; return decodeUInt8;
+        case ST_MPC::RegisterType::Int16:   minLength = 2; return decodeInt16;
+        case ST_MPC::RegisterType::UInt16:  minLength = 2; return decodeUInt16;
         case ST_MPC::RegisterType::Int32:
-            return static_cast<int32_t>(response[2] | (response[3] << 8) |
-                (response[4] << 16) | (response[5] << 24));
-        case ST_MPC::RegisterType::UInt32:
-            return static_cast<uint32_t>(response[2] | (response[3] << 8) |
-                (response[4] << 16) | (response[5] << 24));
-        default:
-            throw std::runtime_error("Unknown register type");
+        case ST_MPC::RegisterType::UInt32:  minLength = 4; return decodeInt32;
+        case ST_MPC::RegisterType::CharPtr: minLength = 1; return decodeText;
+    }
+    throw std::runtime_error("Unknown register type");
+}
+
+void Logger::compileSlots()
+{
+    std::lock_guard<std::mutex> lock(registersMutex);
+    FrameBuilder frameBuilder;
+    slots.clear();
+    for (const auto& reg : registers) {
+        Slot slot;
+        slot.request = frameBuilder.buildGetFrame(1, reg.id);
+        slot.decode = decoderFor(reg.type, slot.minLength);
+        slot.name = reg.name;
+        slots.push_back(std::move(slot));
     }
+    row.values.assign(slots.size(), 0);
+    row.present.assign(slots.size(), 0);
+    slotsVersion = registersVersion.load();
 }
 
 void Logger::loggingThread() 
 {
+    std::vector<uint8_t> response;  // Reused for every reply
+    compileSlots();
     while (running.load()) {
         try {
-            auto timestamp = std::chrono::system_clock::now();
-            std::map<std::string, int32_t> values;
-
-            // Take a snapshot of registers with minimal lock time
-            std::vector<RegisterInfo> regs;
-            {
-                std::lock_guard<std::mutex> lock(registersMutex);
-                regs = registers;
+            if (slotsVersion != registersVersion.load()) {
+                compileSlots();
             }
-
-            if (regs.empty()) {
+            if (slots.empty()) {
                 std::this_thread::sleep_for(config.sampleInterval);
                 continue;
             }
 
-            // Read all registers without locking
-            for (const auto& reg : regs) {
+            row.timestamp = std::chrono::system_clock::now();
+            bool anyPresent = false;
+            for (size_t i = 0; i < slots.size(); ++i) {
+                const Slot& slot = slots[i];
+                row.present[i] = 0;
                 try {
-                    FrameBuilder frameBuilder;
-                    auto frame = frameBuilder.buildGetFrame(1, reg.id);
-                    serial.sendFrame(frame);
-                    auto response = serial.readFrame();
+                    serial.transaction(slot.request, response);
 
-                    if (response.size() >= 4 && response[0] == 0xF0) {
-                        values[reg.name] = extractValue(response, reg.type);
+                    // [ack, payload length, payload, crc]
+                    if (response.size() >= slot.minLength + 3 && response[0] == 0xF0 &&
+                        slot.decode(response.data() + 2, response.size() - 3, row.values[i])) {
+                        row.present[i] = 1;
+                        anyPresent = true;
                     }
                 }
                 catch (const std::exception& e) {
-                    std::cerr << "Error reading " << reg.name << ": " << e.what() << std::endl;
+                    std::cerr << "Error reading " << slot.name << ": " << e.what() << std::endl;
                 }
             }
 
             // Write values if we got any
-            if (!values.empty()) {
-                writeLogLine(timestamp, values);
+            if (anyPresent) {
+                writeLogLine(row);
             }
 
             std::this_thread::sleep_for(config.sampleInterval);
@@ -219,26 +266,29 @@ void Logger::writeHeader()
     logFile.flush();
 }
 
-void Logger::writeLogLine(const std::chrono::system_clock::time_point& timestamp,
-                         const std::map<std::string, int32_t>& values) 
+void Logger::writeLogLine(const Row& row) 
 {
+    line.clear();
+    char number[24];
+    auto append = [this, &number](auto value) {
+        auto result = std::to_chars(number, number + sizeof(number), value);
+        line.append(number, result.ptr);
+    };
+
     if (config.useTimestamp) {
-        auto ts = std::chrono::duration_cast<std::chrono::microseconds>(
-            timestamp.time_since_epoch()).count();
-        logFile << ts;
+        append(std::chrono::duration_cast<std::chrono::microseconds>(
+            row.timestamp.time_since_epoch()).count());
     }
-
-    std::lock_guard<std::mutex> lock(registersMutex);
-    for (const auto& reg : registers) {
-        if (config.useTimestamp || &reg != &registers.front()) {
-            logFile << ",";
+    for (size_t i = 0; i < row.values.size(); ++i) {
+        if (config.useTimestamp || i > 0) {
+            line += ',';
         }
-        auto it = values.find(reg.name);
-        if (it != values.end()) {
-            logFile << it->second;
+        if (row.present[i]) {
+            append(row.values[i]);
         }
     }
-    logFile << "\n";
+    line += '\n';
+    logFile.write(line.data(), static_cast<std::streamsize>(line.size()));
     logFile.flush();
 }
 
@@ -249,8 +299,7 @@ int32_t Logger::readRegisterValue(const RegisterInfo& reg)
     try {
         FrameBuilder frameBuilder;
         auto frame = frameBuilder.buildGetFrame(1, reg.id);
-        serial.sendFrame(frame);
-        auto response = serial.readFrame();
+        auto response = serial.transaction(frame);
 
         if (response.size() < 4) {
             throw std::runtime_error("Invalid response size");
@@ -7,7 +7,6 @@
 #include <chrono>
 #include <fstream>
 #include <mutex>
-#include <map>
 #include <string>
 #include <thread>
 #include <vector>
@@ -46,6 +45,26 @@ private:
         std::string name;
     };
 
+    // Registers compiled into a fixed layout when logging starts or the register set changes;
+    // a sample is a flat row whose entry i belongs to slots[i]. A decoder returns false
+    // when the payload holds no value, leaving the entry absent
+    using DecodeFn = bool (*)(const uint8_t* payload, size_t length, int32_t& value);
+
+    struct Slot
+    {
+        std::vector<uint8_t> request;   // Prebuilt GetRegister frame
+        DecodeFn decode;
+        size_t minLength;               // Payload bytes decode needs
+        std::string name;
+    };
+
+    struct Row
+    {
+        std::chrono::system_clock::time_point timestamp;
+        std::vector<int32_t> values;
+        std::vector<uint8_t> present;
+    };
+
     SerialConnection& serial;
 
     LogConfig config;
@@ -56,16 +75,23 @@ private:
     std::thread loggerThread;               // Thread for logging
     
     std::vector<RegisterInfo> registers;    // Using vector to maintain order
+    std::atomic<uint32_t> registersVersion{0};  // Bumped on every change to registers
+
+    // Owned by the logging thread
+    std::vector<Slot> slots;
+    Row row;
+    uint32_t slotsVersion{0};
+    std::string line;                       // Formatting buffer, reused for every row
     
     static std::mutex readMutex;            // Static mutex for coordinating reads
     mutable std::mutex registersMutex;      // Mutex for protecting registers vector
 
-    int32_t extractValue(const std::vector<uint8_t>& response, ST_MPC::RegisterType type);
+    static DecodeFn decoderFor(ST_MPC::RegisterType type, size_t& minLength);
 
     void loggingThread();
+    void compileSlots();
     void writeHeader();
-    void writeLogLine(const std::chrono::system_clock::time_point& timestamp, 
-                     const std::map<std::string, int32_t>& values);
+    void writeLogLine(const Row& row);
 
     int32_t readRegisterValue(const RegisterInfo& reg);
 
@@ -1,5 +1,11 @@
 #include "SerialConnection.h"
+#include "StMpcDefinitions.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
+#include <termios.h>
+#include <unistd.h>
 
 SerialConnection::SerialConnection(const std::string& port, unsigned int baud_rate)
     : serial(io, port) 
@@ -35,89 +41,203 @@ void SerialConnection::setTimeout(const std::chrono::milliseconds& timeout)
 void SerialConnection::sendFrame(const std::vector<uint8_t>& frame) 
 {
     std::lock_guard<std::mutex> lock(serialMutex);
-    try {
-        boost::asio::write(serial, boost::asio::buffer(frame));
-    } catch (const std::exception& e) {
-        throw ReadError("Error sending frame: " + std::string(e.what()));
-    }
+    writeFrame(frame);
 }
 
 std::vector<uint8_t> SerialConnection::readFrame() 
 {
-    std::lock_guard<std::mutex> lock(serialMutex);
-    try {
-        // Read header first (2 bytes)
-        std::vector<uint8_t> header = readWithTimeout(2);
-        if (header.size() != 2) {
-            throw ReadError("Failed to read header");
-        }
+    std::vector<uint8_t> frame;
+    readFrame(frame);
+    return frame;
+}
 
-        size_t payloadLength = header[1];
-        size_t totalLength = payloadLength + 1; // +1 for CRC
+void SerialConnection::readFrame(std::vector<uint8_t>& frame) 
+{
+    std::lock_guard<std::mutex> lock(serialMutex);
+    if (!readFrameUntil(frame, std::chrono::steady_clock::now() + readTimeout)) {
+        throw ReadError("Read frame error: Timeout");
+    }
+}
 
-        // Read rest of frame
-        std::vector<uint8_t> payload = readWithTimeout(totalLength);
-        if (payload.size() != totalLength) {
-            throw ReadError("Failed to read complete frame");
+std::vector<uint8_t> SerialConnection::readFrame(size_t size) 
+{
+    std::lock_guard<std::mutex> lock(serialMutex);
+    auto deadline = std::chrono::steady_clock::now() + readTimeout;
+    while (rxRing.size() < size) {
+        if (size > rxRing.capacity() || !receive(deadline)) {
+            throw ReadError("Timeout");
         }
+    }
+    std::vector<uint8_t> buffer(size);
+    rxRing.copyOut(buffer.data(), size);
+    rxRing.consume(size);
+    return buffer;
+}
 
-        // Combine header and payload
-        std::vector<uint8_t> complete;
-        complete.reserve(header.size() + payload.size());
-        complete.insert(complete.end(), header.begin(), header.end());
-        complete.insert(complete.end(), payload.begin(), payload.end());
+std::vector<uint8_t> SerialConnection::transaction(const std::vector<uint8_t>& frame)
+{
+    std::vector<uint8_t> reply;
+    transaction(frame, reply);
+    return reply;
+}
 
-        return complete;
+void SerialConnection::transaction(const std::vector<uint8_t>& frame, std::vector<uint8_t>& reply)
+{
+    std::lock_guard<std::mutex> lock(serialMutex);
+    auto& estimator = rto[frame.empty() ? 0 : frame[0] & 0x1F];
+
+    for (unsigned retries = 0;; ++retries) {
+        // Replies carry no id, so drop whatever a timed-out request left behind
+        discardInput();
+        writeFrame(frame);
+        auto sent = std::chrono::steady_clock::now();
+        if (readFrameUntil(reply, sent + estimator.timeout(readTimeout))) {
+            if (retries == 0) {
+                estimator.addSample(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - sent));
+            } else {
+                drainDuplicates(estimator.timeout(readTimeout));
+            }
+            return;
+        }
+        estimator.backoff = std::min(estimator.backoff + 1, MAX_BACKOFF);
+        if (retries == retryLimit(frame)) {
+            if (retries > 0) {
+                drainDuplicates(readTimeout);
+            }
+            throw ReadError("Read frame error: Timeout");
+        }
     }
-    catch (const std::exception& e) {
-        // Clear any partial data that might be in the buffer
-        boost::system::error_code ec;
-        serial.cancel(ec); // Cancel any pending operations
-        throw ReadError(std::string("Read frame error: ") + e.what());
+}
+
+void SerialConnection::writeFrame(const std::vector<uint8_t>& frame)
+{
+    try {
+        boost::asio::write(serial, boost::asio::buffer(frame));
+    } catch (const std::exception& e) {
+        throw ReadError("Error sending frame: " + std::string(e.what()));
     }
 }
 
-std::vector<uint8_t> SerialConnection::readFrame(size_t size) 
+// Waits for a complete frame and copies it into the caller's buffer; false on timeout
+bool SerialConnection::readFrameUntil(std::vector<uint8_t>& frame, std::chrono::steady_clock::time_point deadline) 
 {
-    std::lock_guard<std::mutex> lock(serialMutex);
-    return readWithTimeout(size);
+    // Header is [start, payload length], followed by the payload and the CRC
+    while (rxRing.size() < 2 || rxRing.size() < rxRing[1] + 3u) {
+        if (!receive(deadline)) {
+            return false;
+        }
+    }
+    size_t size = rxRing[1] + 3u;
+    frame.resize(size);
+    rxRing.copyOut(frame.data(), size);
+    rxRing.consume(size);
+    return true;
 }
 
-std::vector<uint8_t> SerialConnection::readWithTimeout(size_t size) 
+// Waits until bytes arrive, then takes all that are available with one read(); false on timeout
+bool SerialConnection::receive(std::chrono::steady_clock::time_point deadline)
 {
-    std::vector<uint8_t> buffer(size);
-    
-    // Simple synchronous read with timeout
-    boost::asio::async_read(serial,
-        boost::asio::buffer(buffer),
-        [](const boost::system::error_code&, size_t){});
-        
-    if (!serial.native_handle()) {
-        throw ReadError("Invalid serial handle");
+    int fd = serial.native_handle();
+    auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+        deadline - std::chrono::steady_clock::now()).count();
+    if (remaining <= 0) {
+        return false;
     }
 
-    // Use select to implement timeout
     fd_set read_fds;
     FD_ZERO(&read_fds);
-    FD_SET(serial.native_handle(), &read_fds);
+    FD_SET(fd, &read_fds);
 
     struct timeval timeout;
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 100000; // 100ms timeout
+    timeout.tv_sec = remaining / 1000000;
+    timeout.tv_usec = remaining % 1000000;
 
-    int result = select(serial.native_handle() + 1, &read_fds, nullptr, nullptr, &timeout);
+    int result = select(fd + 1, &read_fds, nullptr, nullptr, &timeout);
     if (result < 0) {
-        throw ReadError("Select error");
+        if (errno == EINTR) {
+            return true;
+        }
+        throw ReadError("Read frame error: Select error");
     }
     if (result == 0) {
-        throw ReadError("Timeout");
+        return false;
+    }
+
+    if (rxRing.freeSpace() == 0) {
+        rxRing.clear();     // Bytes that never formed a frame
+    }
+    auto region = rxRing.writeRegion();
+    ssize_t n = read(fd, region.data, region.size);
+    if (n < 0) {
+        if (errno == EINTR || errno == EAGAIN) {
+            return true;
+        }
+        throw ReadError(std::string("Read frame error: ") + std::strerror(errno));
+    }
+    if (n == 0) {
+        throw ReadError("Read frame error: Port closed");
     }
+    rxRing.commit(static_cast<size_t>(n));
+    return true;
+}
 
-    // Perform the actual read
-    size_t bytesRead = boost::asio::read(serial, boost::asio::buffer(buffer));
-    if (bytesRead != size) {
-        throw ReadError("Incomplete read");
+// A resent request may be answered more than once, and late. Without ids such a reply would be
+// taken for the next request's, so wait until the line has been quiet for quietTime: one RTO
+// after a retry succeeded, readTimeout (the wait of a request without retries) after giving up
+void SerialConnection::drainDuplicates(std::chrono::microseconds quietTime)
+{
+    auto limit = std::chrono::steady_clock::now() + 2 * readTimeout;
+    while (receive(std::min(std::chrono::steady_clock::now() + quietTime, limit))) {
+        rxRing.clear();
     }
+    discardInput();
+}
 
-    return buffer;
-}
\ No newline at end of file
+void SerialConnection::discardInput()
+{
+    tcflush(serial.native_handle(), TCIFLUSH);
+    rxRing.clear();
+}
+
+unsigned SerialConnection::retryLimit(const std::vector<uint8_t>& request)
+{
+    if (request.empty()) {
+        return 0;
+    }
+    switch (static_cast<ST_MPC::CommandId>(request[0] & 0x1F)) {
+        case ST_MPC::CommandId::GetRegister:
+        case ST_MPC::CommandId::GetInfo:
+        case ST_MPC::CommandId::GetRevup:
+            return READ_RETRIES;
+        case ST_MPC::CommandId::SetRegister:
+        case ST_MPC::CommandId::SetRevup:
+        case ST_MPC::CommandId::SetCurrentRef:
+            return WRITE_RETRIES;
+        default:
+            return 0;
+    }
+}
+
+void SerialConnection::RtoEstimator::addSample(std::chrono::microseconds rtt)
+{
+    if (!valid) {
+        srtt = rtt;
+        rttvar = rtt / 2;
+        valid = true;
+    } else {
+        auto error = rtt - srtt;
+        rttvar += (std::chrono::abs(error) - rttvar) / 4;
+        srtt += error / 8;
+    }
+    backoff = 0;
+}
+
+std::chrono::microseconds SerialConnection::RtoEstimator::timeout(std::chrono::microseconds ceiling) const
+{
+    if (!valid) {
+        return ceiling;
+    }
+    auto rto = (srtt + std::max(MIN_RTO_VARIANCE, 4 * rttvar)) * (1 << backoff);
+    return std::min(std::max(rto, MIN_RTO), ceiling);
+}
@@ -3,6 +3,8 @@
 
 #include <utility>  // known issue with boost::asio and C++17
 #include <boost/asio.hpp>
+#include "ByteRingBuffer.h"
+#include <array>
 #include <string>
 #include <vector>
 #include <chrono>
@@ -22,17 +24,58 @@ public:
 
     void sendFrame(const std::vector<uint8_t>& frame);
     std::vector<uint8_t> readFrame();
+    void readFrame(std::vector<uint8_t>& frame);   // Reuses the caller's buffer
     std::vector<uint8_t> readFrame(size_t size);
-    
+
+    // Send a request and read its reply. The reply timeout adapts to the measured round-trip
+    // time of the command (see RtoEstimator). A request that times out is sent again up to its
+    // class limit: reads are safe to repeat, writes set the same value again, executes are
+    // never repeated. Throws ReadError once the retries are used up. Replies carry no id, so
+    // after a resend any further replies are drained before returning or throwing.
+    std::vector<uint8_t> transaction(const std::vector<uint8_t>& frame);
+    void transaction(const std::vector<uint8_t>& frame, std::vector<uint8_t>& reply);
+
+    // Longest wait for a reply; also the timeout before the first round trip has been measured
     void setTimeout(const std::chrono::milliseconds& timeout);
 
+    static constexpr unsigned READ_RETRIES = 2;
+    static constexpr unsigned WRITE_RETRIES = 1;
+    static constexpr std::chrono::microseconds MIN_RTO{3000};
+    static constexpr std::chrono::microseconds MIN_RTO_VARIANCE{1000};    // Scheduling granularity
+    static constexpr unsigned MAX_BACKOFF = 6;
+
 private:
+    // Retransmission timeout from smoothed round-trip times as in TCP (RFC 6298):
+    // srtt + max(MIN_RTO_VARIANCE, 4 * rttvar), doubled per consecutive timeout and clamped to
+    // [MIN_RTO, readTimeout]. Replies to resent requests are not sampled, they are ambiguous.
+    struct RtoEstimator
+    {
+        std::chrono::microseconds srtt{0};
+        std::chrono::microseconds rttvar{0};
+        unsigned backoff{0};
+        bool valid{false};
+
+        void addSample(std::chrono::microseconds rtt);
+        std::chrono::microseconds timeout(std::chrono::microseconds ceiling) const;
+    };
+
+    static constexpr size_t RX_RING_SIZE = 1024;    // Four maximum-size frames
+
     boost::asio::io_service io;
     boost::asio::serial_port serial;
-    std::chrono::milliseconds readTimeout{1000}; // Default 1 second timeout
+    std::chrono::milliseconds readTimeout{100};
     std::mutex serialMutex;
-    
-    std::vector<uint8_t> readWithTimeout(size_t size);
+    std::array<RtoEstimator, 32> rto;   // By command, the 5 LSB of the start frame
+
+    // Received bytes; frames [start, length, payload, crc] are cut out of it in place
+    ByteRingBuffer rxRing{RX_RING_SIZE};
+
+    bool readFrameUntil(std::vector<uint8_t>& frame, std::chrono::steady_clock::time_point deadline);
+    bool receive(std::chrono::steady_clock::time_point deadline);
+    void discardInput();
+    void drainDuplicates(std::chrono::microseconds quietTime);
+    void writeFrame(const std::vector<uint8_t>& frame);
+    static unsigned retryLimit(const std::vector<uint8_t>& request);
     void configurePort(unsigned int baud_rate);
 };
 